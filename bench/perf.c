@@ -0,0 +1,877 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/* Measures the hardware cost per byte of each codec path with perf_event_open
+ * and compares it against a baseline file.
+ *
+ *   perf [--update] [--tolerance 0.10] [--size 65536] [--kernel name] [baseline.txt]
+ *
+ * --kernel prefixes each path with "name/" so builds of the different codec
+ * kernels can be compared, and share one baseline file.
+ *
+ * The exit code is 0 when nothing regressed, 1 when at least one metric is
+ * more than the tolerance worse than the baseline, 2 when the baseline lacks an
+ * entry for any measured path and metric of the kernel (so that path could
+ * regress unnoticed) and 77 (skipped) when the hardware counters are not
+ * available, for example in most containers.
+ */
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/perf_event.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../include/trower-base64/base16.h"
+#include "../include/trower-base64/base32.h"
+#include "../include/trower-base64/base64.h"
+#include "../include/trower-base64/cache.h"
+#include "../include/trower-base64/fd.h"
+#include "../include/trower-base64/pem.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                   Macros                                   */
+/*----------------------------------------------------------------------------*/
+#define EXIT_REGRESSION  1
+#define EXIT_NO_BASELINE 2
+#define EXIT_SKIP        77
+
+/* The line --update writes to record how the numbers were taken.  It replaces
+ * any earlier one, while the rest of the file's leading comment is kept. */
+#define GENERATED_LINE "# generated by bench/perf --update"
+
+/* Each path processes at least this many bytes per measurement. */
+#define TARGET_BYTES (64 * 1024 * 1024)
+
+/* Near zero metrics (misses) are allowed this much absolute slack per byte
+ * on top of the relative tolerance, so noise on a tiny number does not fail
+ * the run. */
+#define ABS_SLACK 0.0005
+
+/* The encode cache paths cycle through this many MAC address sized keys. */
+#define KEYS    256
+#define KEY_LEN 6
+
+/* The PEM path splits the raw data into certificate sized blocks. */
+#define PEM_BLOCK 1024
+
+/*----------------------------------------------------------------------------*/
+/*                               Data Structures                              */
+/*----------------------------------------------------------------------------*/
+enum metric {
+    M_CYCLES = 0,
+    M_INSTRUCTIONS,
+    M_BRANCH_MISSES,
+    M_L1D_MISSES,
+
+    M_COUNT
+};
+
+struct ctx {
+    size_t size; /* raw bytes per run */
+
+    uint8_t *raw;
+    uint8_t *enc;
+    size_t enc_len;
+    uint8_t *url;
+    size_t url_len;
+    uint16_t *enc16;
+    uint8_t *hex;
+    size_t hex_len;
+    uint8_t *b32;
+    size_t b32_len;
+    uint8_t *json;
+    size_t json_len;
+    char *pem;
+    size_t pem_len;
+    size_t pem_count;
+
+    uint8_t *out;
+    uint16_t *out16;
+    uint32_t sum; /* what the consumer paths compute, so it isn't dropped */
+
+    /* Unlinked temporary files holding raw and enc, and /dev/null. */
+    int raw_fd;
+    int enc_fd;
+    int null_fd;
+
+    uint8_t keys[KEYS][KEY_LEN];
+    b64_cache_t *warm; /* holds every key */
+    b64_cache_t *full; /* full of other values, so every key is turned away */
+};
+
+struct path {
+    const char *name;
+
+    /* Runs the path once and returns the number of input bytes consumed, or
+     * 0 on failure. */
+    size_t (*run)(struct ctx *);
+};
+
+struct baseline {
+    char path[64];
+    char metric[32];
+    double value;
+};
+
+/* Two paths where the first must take fewer cycles than the second, whatever
+ * the baseline says. */
+struct ordering {
+    const char *cheaper;
+    const char *than;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                            File Scoped Variables                           */
+/*----------------------------------------------------------------------------*/
+static const char *metric_names[M_COUNT] = {
+    [M_CYCLES]        = "cycles",
+    [M_INSTRUCTIONS]  = "instructions",
+    [M_BRANCH_MISSES] = "branch-misses",
+    [M_L1D_MISSES]    = "l1d-misses",
+};
+
+/*----------------------------------------------------------------------------*/
+/*                               Codec Paths                                  */
+/*----------------------------------------------------------------------------*/
+static size_t run_encode(struct ctx *c)
+{
+    b64_encode(c->raw, c->size, c->out);
+    return c->size;
+}
+
+static size_t run_decode(struct ctx *c)
+{
+    return (c->size == b64_decode(c->enc, c->enc_len, c->out)) ? c->enc_len : 0;
+}
+
+static size_t run_url_encode(struct ctx *c)
+{
+    b64url_encode(c->raw, c->size, c->out);
+    return c->size;
+}
+
+static size_t run_url_decode(struct ctx *c)
+{
+    return (c->size == b64url_decode(c->url, c->url_len, c->out)) ? c->url_len : 0;
+}
+
+static size_t run_decode_flags(struct ctx *c)
+{
+    size_t rv = b64_decode_flags(c->url, c->url_len, c->out, B64_DECODE_ANY_ALPHABET);
+    return (c->size == rv) ? c->url_len : 0;
+}
+
+/* The same input and output as b64_decode, so the two costs compare directly. */
+static size_t run_decode_ct(struct ctx *c)
+{
+    size_t rv = b64_decode_flags(c->enc, c->enc_len, c->out,
+                                 B64_DECODE_PAD_REQUIRED | B64_DECODE_CONSTANT_TIME);
+    return (c->size == rv) ? c->enc_len : 0;
+}
+
+/* A stand in for a parser (protobuf, CBOR, ...) that reads every decoded byte
+ * once.  The consume paths decode the same input as b64_decode, then read the
+ * result back: all at once from the output buffer, or a chunk at a time while
+ * it is still in the cache. */
+static uint32_t consume(const uint8_t *raw, size_t len, uint32_t sum)
+{
+    for (size_t i = 0; i < len; i++) {
+        sum = sum * 31 + raw[i];
+    }
+    return sum;
+}
+
+static int consume_chunk(const uint8_t *raw, size_t len, void *user)
+{
+    struct ctx *c = user;
+
+    c->sum = consume(raw, len, c->sum);
+    return 0;
+}
+
+static size_t run_decode_consume(struct ctx *c)
+{
+    size_t rv = b64_decode(c->enc, c->enc_len, c->out);
+
+    c->sum = consume(c->out, rv, 0);
+    return (c->size == rv) ? c->enc_len : 0;
+}
+
+static size_t run_decode_chunked(struct ctx *c)
+{
+    size_t rv;
+
+    c->sum = 0;
+    rv     = b64_decode_chunked(c->enc, c->enc_len, B64_DECODE_PAD_REQUIRED, consume_chunk, c);
+    return (c->size == rv) ? c->enc_len : 0;
+}
+
+static size_t run_decode_json(struct ctx *c)
+{
+    return (c->size == b64_decode_json(c->json, c->json_len, c->out)) ? c->json_len : 0;
+}
+
+static size_t run_encode_utf16(struct ctx *c)
+{
+    b64_encode_utf16(c->raw, c->size, c->out16);
+    return c->size;
+}
+
+static size_t run_decode_utf16(struct ctx *c)
+{
+    return (c->size == b64_decode_utf16(c->enc16, c->enc_len, c->out)) ? c->enc_len : 0;
+}
+
+static size_t run_b16_encode(struct ctx *c)
+{
+    b16_encode(c->raw, c->size, c->out);
+    return c->size;
+}
+
+static size_t run_b16_decode(struct ctx *c)
+{
+    return (c->size == b16_decode(c->hex, c->hex_len, c->out)) ? c->hex_len : 0;
+}
+
+static size_t run_b32_encode(struct ctx *c)
+{
+    b32_encode(c->raw, c->size, c->out);
+    return c->size;
+}
+
+static size_t run_b32_decode(struct ctx *c)
+{
+    return (c->size == b32_decode(c->b32, c->b32_len, c->out)) ? c->b32_len : 0;
+}
+
+/* The small value paths compare plain encoding of the keys with a cache that
+ * holds them and with one that can't, i.e. the best and worst case. */
+static size_t run_encode_small(struct ctx *c)
+{
+    for (size_t i = 0; i < KEYS; i++) {
+        b64_encode(c->keys[i], KEY_LEN, c->out);
+    }
+    return KEYS * KEY_LEN;
+}
+
+static size_t run_cache_hit(struct ctx *c)
+{
+    for (size_t i = 0; i < KEYS; i++) {
+        if (!b64_cache_encode(c->warm, c->keys[i], KEY_LEN, NULL)) {
+            return 0;
+        }
+    }
+    return KEYS * KEY_LEN;
+}
+
+static size_t run_cache_miss(struct ctx *c)
+{
+    for (size_t i = 0; i < KEYS; i++) {
+        if (b64_cache_encode(c->full, c->keys[i], KEY_LEN, NULL)) {
+            return 0;
+        }
+        b64_encode(c->keys[i], KEY_LEN, c->out);
+    }
+    return KEYS * KEY_LEN;
+}
+
+static size_t run_pem_decode(struct ctx *c)
+{
+    b64_pem_t pem;
+    size_t count = b64_pem_decode((const uint8_t *) c->pem, c->pem_len, &pem);
+
+    b64_pem_free(&pem);
+    return (c->pem_count == count) ? c->pem_len : 0;
+}
+
+/* The fd paths are compared with copying the same file unchanged, the way
+ * cat(1) would.  The counters only see the calling thread, so the wall clock
+ * is the figure to compare. */
+static size_t run_cat(struct ctx *c)
+{
+    uint8_t *buf = c->out;
+    size_t bytes = 0;
+    ssize_t n;
+
+    lseek(c->raw_fd, 0, SEEK_SET);
+    while (0 < (n = read(c->raw_fd, buf, c->enc_len))) {
+        if (n != write(c->null_fd, buf, (size_t) n)) {
+            return 0;
+        }
+        bytes += (size_t) n;
+    }
+    return (c->size == bytes) ? bytes : 0;
+}
+
+static size_t run_encode_fd(struct ctx *c)
+{
+    lseek(c->raw_fd, 0, SEEK_SET);
+    return (0 == b64_encode_fd(c->raw_fd, c->null_fd, B64_ENCODE_STANDARD)) ? c->size : 0;
+}
+
+static size_t run_decode_fd(struct ctx *c)
+{
+    lseek(c->enc_fd, 0, SEEK_SET);
+    return (0 == b64_decode_fd(c->enc_fd, c->null_fd, B64_DECODE_STANDARD)) ? c->enc_len : 0;
+}
+
+static const struct path paths[] = {
+    { "b64_encode",         run_encode         },
+    { "b64_decode",         run_decode         },
+    { "b64url_encode",      run_url_encode     },
+    { "b64url_decode",      run_url_decode     },
+    { "b64_decode_flags",   run_decode_flags   },
+    { "b64_decode_ct",      run_decode_ct      },
+    { "b64_decode_consume", run_decode_consume },
+    { "b64_decode_chunked", run_decode_chunked },
+    { "b64_decode_json",    run_decode_json    },
+    { "b64_encode_utf16",   run_encode_utf16   },
+    { "b64_decode_utf16",   run_decode_utf16   },
+    { "b16_encode",         run_b16_encode     },
+    { "b16_decode",         run_b16_decode     },
+    { "b32_encode",         run_b32_encode     },
+    { "b32_decode",         run_b32_decode     },
+    { "b64_encode_small",   run_encode_small   },
+    { "b64_cache_hit",      run_cache_hit      },
+    { "b64_cache_miss",     run_cache_miss     },
+    { "b64_pem_decode",     run_pem_decode     },
+    { "cat",                run_cat            },
+    { "b64_encode_fd",      run_encode_fd      },
+    { "b64_decode_fd",      run_decode_fd      },
+};
+
+/* A cache hit that costs as much as encoding the key defeats the cache. */
+static const struct ordering orderings[] = {
+    { "b64_cache_hit", "b64_encode_small" },
+};
+
+/*----------------------------------------------------------------------------*/
+/*                              Counter Handling                              */
+/*----------------------------------------------------------------------------*/
+static int counter_open(enum metric m)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size           = sizeof(attr);
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+
+    switch (m) {
+        case M_CYCLES:
+            attr.type   = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case M_INSTRUCTIONS:
+            attr.type   = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case M_BRANCH_MISSES:
+            attr.type   = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case M_L1D_MISSES:
+            attr.type   = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D
+                          | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                          | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        default:
+            return -1;
+    }
+
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec * 1e9 + (double) ts.tv_nsec;
+}
+
+/* Measures one path, filling per_byte[] with the cost of each metric per
+ * input byte (negative if the counter is not available).  Returns the wall
+ * clock nanoseconds per byte, or a negative value if the path failed. */
+static double measure(const struct path *p, struct ctx *c, const int *fds, double *per_byte)
+{
+    uint64_t counts[M_COUNT] = { 0 };
+    size_t bytes             = 0;
+    size_t per_run           = p->run(c); /* warm up the caches */
+    double start, stop;
+
+    if (0 == per_run) {
+        return -1.0;
+    }
+
+    for (int m = 0; m < M_COUNT; m++) {
+        if (0 <= fds[m]) {
+            ioctl(fds[m], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fds[m], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    start = now_ns();
+    while (bytes < TARGET_BYTES) {
+        bytes += p->run(c);
+    }
+    stop = now_ns();
+
+    for (int m = 0; m < M_COUNT; m++) {
+        per_byte[m] = -1.0;
+        if (0 <= fds[m]) {
+            ioctl(fds[m], PERF_EVENT_IOC_DISABLE, 0);
+            if (sizeof(counts[m]) == read(fds[m], &counts[m], sizeof(counts[m]))) {
+                per_byte[m] = (double) counts[m] / (double) bytes;
+            }
+        }
+    }
+
+    return (stop - start) / (double) bytes;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                              Baseline Handling                             */
+/*----------------------------------------------------------------------------*/
+static size_t baseline_load(const char *file, struct baseline **out)
+{
+    struct baseline *list = NULL;
+    size_t count          = 0;
+    char line[256];
+    FILE *f;
+
+    *out = NULL;
+    if (!file) {
+        return 0;
+    }
+
+    f = fopen(file, "r");
+    if (!f) {
+        fprintf(stderr, "warning: unable to read baseline '%s': %s\n", file, strerror(errno));
+        return 0;
+    }
+
+    while (fgets(line, sizeof(line), f)) {
+        struct baseline b;
+        struct baseline *tmp;
+
+        if (('#' == line[0])
+            || (3 != sscanf(line, "%63s %31s %lf", b.path, b.metric, &b.value)))
+        {
+            continue;
+        }
+
+        tmp = realloc(list, (count + 1) * sizeof(struct baseline));
+        if (!tmp) {
+            break;
+        }
+        list          = tmp;
+        list[count++] = b;
+    }
+    fclose(f);
+
+    *out = list;
+    return count;
+}
+
+/* Returns the comment lines at the top of the file (the SPDX header and the
+ * usage notes), without an earlier GENERATED_LINE, or NULL if there are none. */
+static char *baseline_header(const char *file)
+{
+    char *header = NULL;
+    size_t len   = 0;
+    char line[256];
+    FILE *f;
+
+    f = file ? fopen(file, "r") : NULL;
+    if (!f) {
+        return NULL;
+    }
+
+    while (fgets(line, sizeof(line), f) && ('#' == line[0])) {
+        size_t n = strlen(line);
+        char *tmp;
+
+        if (0 == strncmp(line, GENERATED_LINE, sizeof(GENERATED_LINE) - 1)) {
+            continue;
+        }
+
+        tmp = realloc(header, len + n + 1);
+        if (!tmp) {
+            break;
+        }
+        header = tmp;
+        memcpy(&header[len], line, n + 1);
+        len += n;
+    }
+    fclose(f);
+
+    return header;
+}
+
+static const struct baseline *baseline_find(const struct baseline *list, size_t count,
+                                            const char *path, const char *metric)
+{
+    for (size_t i = 0; i < count; i++) {
+        if ((0 == strcmp(list[i].path, path)) && (0 == strcmp(list[i].metric, metric))) {
+            return &list[i];
+        }
+    }
+    return NULL;
+}
+
+/* Whether a baseline entry belongs to the kernel being measured. */
+static int baseline_is_ours(const struct baseline *b, const char *kernel)
+{
+    size_t len = kernel ? strlen(kernel) : 0;
+
+    if (!kernel) {
+        return NULL == strchr(b->path, '/');
+    }
+    return (0 == strncmp(b->path, kernel, len)) && ('/' == b->path[len]);
+}
+
+/* Returns the cycles per byte measured for the named path, or a negative
+ * value if it was not measured. */
+static double path_cycles(const double *cycles, const char *name)
+{
+    for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); i++) {
+        if (0 == strcmp(paths[i].name, name)) {
+            return cycles[i];
+        }
+    }
+    return -1.0;
+}
+
+/* Checks the orderings against the measured cycles per byte of each path
+ * (negative if not measured) and returns the number that do not hold. */
+static int orderings_check(const double *cycles)
+{
+    int broken = 0;
+
+    for (size_t i = 0; i < sizeof(orderings) / sizeof(orderings[0]); i++) {
+        double a = path_cycles(cycles, orderings[i].cheaper);
+        double b = path_cycles(cycles, orderings[i].than);
+
+        if ((a < 0.0) || (b < 0.0)) {
+            continue;
+        }
+        printf("%s vs %s: %.4f vs %.4f cycles/B\n", orderings[i].cheaper, orderings[i].than, a,
+               b);
+        if (b <= a) {
+            printf("    SLOWER %s is not cheaper than %s\n", orderings[i].cheaper,
+                   orderings[i].than);
+            broken++;
+        }
+    }
+
+    return broken;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                    Setup                                   */
+/*----------------------------------------------------------------------------*/
+static int file_with(const uint8_t *data, size_t len)
+{
+    char name[] = "/tmp/b64-perf-XXXXXX";
+    int fd      = mkstemp(name);
+
+    if (0 <= fd) {
+        unlink(name);
+        if ((ssize_t) len != write(fd, data, len)) {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    return fd;
+}
+
+static int ctx_init(struct ctx *c, size_t size)
+{
+    memset(c, 0, sizeof(*c));
+    c->raw_fd  = -1;
+    c->enc_fd  = -1;
+    c->null_fd = -1;
+    c->size    = size;
+    c->enc_len = b64_get_encoded_buffer_size(size);
+    c->url_len = b64url_get_encoded_buffer_size(size);
+    c->hex_len = b16_get_encoded_buffer_size(size);
+    c->b32_len = b32_get_encoded_buffer_size(size);
+
+    c->raw   = malloc(size);
+    c->enc   = malloc(c->enc_len);
+    c->url   = malloc(c->url_len);
+    c->enc16 = malloc(c->enc_len * sizeof(uint16_t));
+    c->hex   = malloc(c->hex_len);
+    c->b32   = malloc(c->b32_len);
+    c->json  = malloc(c->enc_len * 2);
+    c->pem   = malloc(c->enc_len * 2 + 64 * (size / PEM_BLOCK + 1));
+    c->out   = malloc(c->enc_len * sizeof(uint16_t));
+    c->out16 = malloc(c->enc_len * sizeof(uint16_t));
+
+    if (!c->raw || !c->enc || !c->url || !c->enc16 || !c->hex || !c->b32 || !c->json || !c->pem
+        || !c->out || !c->out16)
+    {
+        return -1;
+    }
+
+    srand(42);
+    for (size_t i = 0; i < size; i++) {
+        c->raw[i] = (uint8_t) rand();
+    }
+
+    b64_encode(c->raw, size, c->enc);
+    b64url_encode(c->raw, size, c->url);
+    b64_encode_utf16(c->raw, size, c->enc16);
+    b16_encode(c->raw, size, c->hex);
+    b32_encode(c->raw, size, c->b32);
+
+    /* Escape the '/' characters like a JSON producer would. */
+    for (size_t i = 0; i < c->enc_len; i++) {
+        if ('/' == c->enc[i]) {
+            c->json[c->json_len++] = '\\';
+        }
+        c->json[c->json_len++] = c->enc[i];
+    }
+
+    /* A CA bundle like file of PEM_BLOCK byte certificates in 64 column
+     * lines. */
+    for (size_t off = 0; off < size; off += PEM_BLOCK) {
+        size_t len = (PEM_BLOCK < size - off) ? PEM_BLOCK : size - off;
+        size_t enc = b64_get_encoded_buffer_size(len);
+
+        c->pem_len += sprintf(&c->pem[c->pem_len], "-----BEGIN CERTIFICATE-----\n");
+        b64_encode(&c->raw[off], len, c->out);
+        for (size_t i = 0; i < enc; i += 64) {
+            size_t n = (64 < enc - i) ? 64 : enc - i;
+
+            memcpy(&c->pem[c->pem_len], &c->out[i], n);
+            c->pem_len += n;
+            c->pem[c->pem_len++] = '\n';
+        }
+        c->pem_len += sprintf(&c->pem[c->pem_len], "-----END CERTIFICATE-----\n");
+        c->pem_count++;
+    }
+
+    c->raw_fd  = file_with(c->raw, size);
+    c->enc_fd  = file_with(c->enc, c->enc_len);
+    c->null_fd = open("/dev/null", O_WRONLY);
+    if ((c->raw_fd < 0) || (c->enc_fd < 0) || (c->null_fd < 0)) {
+        return -1;
+    }
+
+    c->warm = b64_cache_create(KEYS, KEY_LEN);
+    c->full = b64_cache_create(KEYS, KEY_LEN);
+    if (!c->warm || !c->full) {
+        return -1;
+    }
+    for (size_t i = 0; i < KEYS; i++) {
+        uint8_t other[KEY_LEN] = { 0xff, (uint8_t) i };
+
+        for (size_t j = 0; j < KEY_LEN; j++) {
+            c->keys[i][j] = (uint8_t) rand();
+        }
+        b64_cache_encode(c->warm, c->keys[i], KEY_LEN, NULL);
+        b64_cache_encode(c->full, other, KEY_LEN, NULL);
+    }
+
+    return 0;
+}
+
+static void ctx_destroy(struct ctx *c)
+{
+    free(c->raw);
+    free(c->enc);
+    free(c->url);
+    free(c->enc16);
+    free(c->hex);
+    free(c->b32);
+    free(c->json);
+    free(c->pem);
+    free(c->out);
+    free(c->out16);
+    b64_cache_destroy(c->warm);
+    b64_cache_destroy(c->full);
+    if (0 <= c->raw_fd) {
+        close(c->raw_fd);
+    }
+    if (0 <= c->enc_fd) {
+        close(c->enc_fd);
+    }
+    if (0 <= c->null_fd) {
+        close(c->null_fd);
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             External Functions                             */
+/*----------------------------------------------------------------------------*/
+int main(int argc, char *argv[])
+{
+    const char *file      = NULL;
+    const char *kernel    = NULL;
+    struct baseline *base = NULL;
+    FILE *update_f        = NULL;
+    char *header          = NULL;
+    size_t base_count     = 0;
+    size_t missing        = 0;
+    double tolerance      = 0.10;
+    size_t size           = 64 * 1024;
+    int update            = 0;
+    int have_hw           = 0;
+    int regressions       = 0;
+    int fds[M_COUNT];
+    double cycles[sizeof(paths) / sizeof(paths[0])];
+    struct ctx c;
+
+    for (int i = 1; i < argc; i++) {
+        if (0 == strcmp("--update", argv[i])) {
+            update = 1;
+        } else if ((0 == strcmp("--tolerance", argv[i])) && (i + 1 < argc)) {
+            tolerance = strtod(argv[++i], NULL);
+        } else if ((0 == strcmp("--size", argv[i])) && (i + 1 < argc)) {
+            size = (size_t) strtoull(argv[++i], NULL, 0);
+        } else if ((0 == strcmp("--kernel", argv[i])) && (i + 1 < argc)) {
+            kernel = argv[++i];
+        } else {
+            file = argv[i];
+        }
+    }
+
+    if ((0 == size) || (0 != ctx_init(&c, size))) {
+        fprintf(stderr, "error: unable to set up %zu byte buffers\n", size);
+        return EXIT_FAILURE;
+    }
+
+    for (int m = 0; m < M_COUNT; m++) {
+        fds[m] = counter_open((enum metric) m);
+        if (0 <= fds[m]) {
+            have_hw = 1;
+        }
+    }
+
+    base_count = baseline_load(file, &base);
+
+    if (update) {
+        header   = baseline_header(file);
+        update_f = file ? fopen(file, "w") : stdout;
+        if (!update_f) {
+            fprintf(stderr, "error: unable to write '%s': %s\n", file, strerror(errno));
+            free(header);
+            free(base);
+            ctx_destroy(&c);
+            return EXIT_FAILURE;
+        }
+        if (header) {
+            fputs(header, update_f);
+            free(header);
+        }
+        fprintf(update_f, GENERATED_LINE ", %zu byte inputs\n", size);
+
+        /* Only this kernel's numbers are replaced. */
+        for (size_t i = 0; i < base_count; i++) {
+            if (!baseline_is_ours(&base[i], kernel)) {
+                fprintf(update_f, "%s %s %.6f\n", base[i].path, base[i].metric, base[i].value);
+            }
+        }
+    }
+
+    printf("%-28s %10s", "path", "ns/B");
+    for (int m = 0; m < M_COUNT; m++) {
+        printf(" %14s", metric_names[m]);
+    }
+    printf("\n");
+
+    for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); i++) {
+        double per_byte[M_COUNT];
+        double ns = measure(&paths[i], &c, fds, per_byte);
+        char name[64];
+
+        snprintf(name, sizeof(name), "%s%s%s", kernel ? kernel : "", kernel ? "/" : "",
+                 paths[i].name);
+        cycles[i] = (ns < 0.0) ? -1.0 : per_byte[M_CYCLES];
+
+        if (ns < 0.0) {
+            printf("%-28s FAILED\n", name);
+            regressions++;
+            continue;
+        }
+
+        printf("%-28s %10.4f", name, ns);
+        for (int m = 0; m < M_COUNT; m++) {
+            if (per_byte[m] < 0.0) {
+                printf(" %14s", "n/a");
+            } else {
+                printf(" %14.6f", per_byte[m]);
+            }
+        }
+        printf("\n");
+
+        for (int m = 0; m < M_COUNT; m++) {
+            const struct baseline *b;
+
+            if (per_byte[m] < 0.0) {
+                continue;
+            }
+            if (update_f) {
+                fprintf(update_f, "%s %s %.6f\n", name, metric_names[m], per_byte[m]);
+                continue;
+            }
+
+            b = baseline_find(base, base_count, name, metric_names[m]);
+            if (!b) {
+                printf("    MISSING %s %s has no baseline entry\n", name, metric_names[m]);
+                missing++;
+            } else if (b->value * (1.0 + tolerance) + ABS_SLACK < per_byte[m]) {
+                printf("    REGRESSION %s %s: %.6f > %.6f (+%.1f%%)\n",
+                       name, metric_names[m], per_byte[m], b->value,
+                       100.0 * (per_byte[m] - b->value) / b->value);
+                regressions++;
+            }
+        }
+    }
+
+    if (!update_f) {
+        regressions += orderings_check(cycles);
+    }
+
+    for (int m = 0; m < M_COUNT; m++) {
+        if (0 <= fds[m]) {
+            close(fds[m]);
+        }
+    }
+    if (update_f && (stdout != update_f)) {
+        fclose(update_f);
+    }
+    free(base);
+    ctx_destroy(&c);
+
+    if (regressions) {
+        return EXIT_REGRESSION;
+    }
+    if (!have_hw) {
+        printf("hardware counters are not available, comparison skipped\n");
+        return EXIT_SKIP;
+    }
+
+    /* A gate with holes in it must not pass: every measured metric of every
+     * path needs an entry to be compared against. */
+    if (!update && missing) {
+        printf("error: '%s' lacks %zu entries for the %s kernel; record them on the "
+               "reference machine with --update\n",
+               file ? file : "(no baseline)", missing, kernel ? kernel : "default");
+        return EXIT_NO_BASELINE;
+    }
+    return EXIT_SUCCESS;
+}
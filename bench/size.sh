@@ -0,0 +1,18 @@
+#!/bin/sh
+# SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC
+# SPDX-License-Identifier: Apache-2.0
+#
+# Prints the code (text, which includes the read only tables), data and bss
+# bytes of each kernel's build of the library, largest first.
+#
+#   size.sh <size program> <kernel> <static library> [<kernel> <static library> ...]
+
+size_bin=$1
+shift
+
+printf '%-12s %8s %8s %8s %8s\n' kernel text data bss total
+while [ 2 -le $# ]; do
+    "$size_bin" --totals "$2" |
+        awk -v k="$1" '/TOTALS/ { printf "%-12s %8d %8d %8d %8d\n", k, $1, $2, $3, $4 }'
+    shift 2
+done | sort -k5 -n -r
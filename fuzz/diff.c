@@ -0,0 +1,426 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "base16.h"
+#include "base32.h"
+#include "base64.h"
+#include "diff.h"
+#include "reference.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                   Macros                                   */
+/*----------------------------------------------------------------------------*/
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+/* In the scalar build the ref_* functions are the code under test, so the
+ * paths that would only be compared with themselves are skipped there. */
+#if defined(B64_KERNEL_SWAR) || defined(B64_KERNEL_TABLEFREE)
+#define SELF_REFERENCE 0
+#else
+#define SELF_REFERENCE 1
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*                               Data Structures                              */
+/*----------------------------------------------------------------------------*/
+typedef void (*encode_fn)(const uint8_t *, const size_t, uint8_t *);
+typedef size_t (*decode_fn)(const uint8_t *, const size_t, uint8_t *);
+typedef size_t (*size_fn)(const size_t);
+
+struct encoder {
+    const char *name;
+    encode_fn fn;
+    encode_fn ref;
+    size_fn size;
+};
+
+struct decoder {
+    const char *name;
+    decode_fn fn;
+    decode_fn ref;
+    size_fn size; /* the documented output size, or NULL for (len / 4) * 3 + 2 */
+};
+
+/* Where b64_decode_chunked() puts the chunks back together. */
+struct sink {
+    uint8_t *data;
+    size_t len;
+    size_t size;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                            File Scoped Variables                           */
+/*----------------------------------------------------------------------------*/
+static const struct encoder encoders[] = {
+    { "b64_encode",    b64_encode,    ref_b64_encode,    b64_get_encoded_buffer_size    },
+    { "b64url_encode", b64url_encode, ref_b64url_encode, b64url_get_encoded_buffer_size },
+    { "b16_encode",    b16_encode,    ref_b16_encode,    b16_get_encoded_buffer_size    },
+    { "b32_encode",    b32_encode,    ref_b32_encode,    b32_get_encoded_buffer_size    },
+    { "b32hex_encode", b32hex_encode, ref_b32hex_encode, b32_get_encoded_buffer_size    },
+};
+
+// clang-format off
+/* The functions the frozen codec has, compared in every build. */
+static const struct encoder frozen_encoders[] = {
+    { "b64_encode (frozen)",    b64_encode,    frozen_b64_encode,    b64_get_encoded_buffer_size    },
+    { "b64url_encode (frozen)", b64url_encode, frozen_b64url_encode, b64url_get_encoded_buffer_size },
+};
+
+static const struct decoder decoders[] = {
+    { "b64_decode",         b64_decode,         ref_b64_decode,         b64_get_decoded_buffer_size    },
+    { "b64url_decode",      b64url_decode,      ref_b64url_decode,      b64url_get_decoded_buffer_size },
+    { "b64_decode_json",    b64_decode_json,    ref_b64_decode_json,    NULL                           },
+    { "b64url_decode_json", b64url_decode_json, ref_b64url_decode_json, NULL                           },
+    { "b16_decode",         b16_decode,         ref_b16_decode,         b16_get_decoded_buffer_size    },
+    { "b32_decode",         b32_decode,         ref_b32_decode,         b32_get_decoded_buffer_size    },
+    { "b32hex_decode",      b32hex_decode,      ref_b32hex_decode,      b32_get_decoded_buffer_size    },
+};
+
+static const struct decoder frozen_decoders[] = {
+    { "b64_decode (frozen)",    b64_decode,    frozen_b64_decode,    b64_get_decoded_buffer_size    },
+    { "b64url_decode (frozen)", b64url_decode, frozen_b64url_decode, b64url_get_decoded_buffer_size },
+};
+// clang-format on
+
+/* Every alphabet and padding policy, each with and without the constant
+ * time mode. */
+static const unsigned alphabets[] = { B64_DECODE_STANDARD, B64_DECODE_URL, B64_DECODE_ANY_ALPHABET };
+static const unsigned paddings[]  = { B64_DECODE_PAD_OPTIONAL, B64_DECODE_PAD_REQUIRED,
+                                      B64_DECODE_PAD_FORBIDDEN };
+
+/* What a corrupted encoding gets: padding, characters from the other
+ * alphabet, JSON escapes, whitespace, NUL and bytes outside ASCII. */
+static const uint8_t corruptions[] = { '=', 'A', '/', '+', '-', '_', '\\', 'u', '0', ' ',
+                                       '\n', '\0', 0x80, 0xff };
+
+/*----------------------------------------------------------------------------*/
+/*                             Function Prototypes                            */
+/*----------------------------------------------------------------------------*/
+static int encode_all(const uint8_t *raw, size_t len);
+static int encode_table(const struct encoder *t, size_t count, const uint8_t *raw, size_t len);
+static int decode_all(const uint8_t *text, size_t len);
+static int decode_table(const struct decoder *t, size_t count, const uint8_t *text, size_t len);
+static int decode_flags_all(const uint8_t *text, size_t len);
+static int decode_utf16(const uint8_t *text, size_t len);
+static int decode_corrupted(uint8_t *text, size_t len, unsigned pick);
+static int collect(const uint8_t *raw, size_t len, void *user);
+static int differs(const char *path, size_t len, size_t got, size_t want, const void *out,
+                   const void *ref);
+static void *alloc(size_t size);
+
+/*----------------------------------------------------------------------------*/
+/*                             External Functions                             */
+/*----------------------------------------------------------------------------*/
+const char *diff_kernel(void)
+{
+#if defined(B64_KERNEL_SWAR)
+    return "swar";
+#elif defined(B64_KERNEL_TABLEFREE)
+    return "tablefree";
+#else
+    return "scalar";
+#endif
+}
+
+
+int diff_input(const uint8_t *data, size_t len)
+{
+    unsigned pick      = len ? data[0] : 0;
+    const uint8_t *raw = len ? &data[1] : data;
+    int rv;
+
+    len = len ? len - 1 : 0;
+
+    rv = encode_all(raw, len);
+    if (0 == rv) {
+        rv = decode_all(raw, len);
+    }
+
+    /* Random text is rarely valid, so decode the reference's encodings of it
+     * too, whole and with one character replaced. */
+    for (size_t i = 0; (0 == rv) && (i < ARRAY_SIZE(encoders)); i++) {
+        size_t n      = encoders[i].size(len);
+        uint8_t *text = alloc(n);
+
+        encoders[i].ref(raw, len, text);
+        rv = decode_all(text, n);
+        if (0 == rv) {
+            rv = decode_corrupted(text, n, pick);
+        }
+        free(text);
+    }
+
+    return rv;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                             Internal functions                             */
+/*----------------------------------------------------------------------------*/
+
+static int encode_all(const uint8_t *raw, size_t len)
+{
+    b64_buf_t buf = { 0 };
+    b64_buf_t ref = { 0 };
+    size_t n      = b64_get_encoded_buffer_size(len);
+    uint16_t *out = alloc(n * sizeof(uint16_t));
+    uint16_t *exp = alloc(n * sizeof(uint16_t));
+    int rv        = encode_table(frozen_encoders, ARRAY_SIZE(frozen_encoders), raw, len);
+
+    if ((0 == rv) && !SELF_REFERENCE) {
+        rv = encode_table(encoders, ARRAY_SIZE(encoders), raw, len);
+    }
+    if ((0 == rv) && !SELF_REFERENCE) {
+        b64_encode_utf16(raw, len, out);
+        ref_b64_encode_utf16(raw, len, exp);
+        rv = differs("b64_encode_utf16", len, n * 2, n * 2, out, exp);
+    }
+    if ((0 == rv) && !SELF_REFERENCE) {
+        n = b64url_get_encoded_buffer_size(len);
+        b64url_encode_utf16(raw, len, out);
+        ref_b64url_encode_utf16(raw, len, exp);
+        rv = differs("b64url_encode_utf16", len, n * 2, n * 2, out, exp);
+    }
+    if ((0 == rv) && !SELF_REFERENCE) {
+        b64_encode_append(&buf, raw, len);
+        ref_b64_encode_append(&ref, raw, len);
+        rv = differs("b64_encode_append", len, buf.len, ref.len, buf.data, ref.data);
+    }
+
+    free(buf.data);
+    free(ref.data);
+    free(out);
+    free(exp);
+
+    return rv;
+}
+
+static int encode_table(const struct encoder *t, size_t count, const uint8_t *raw, size_t len)
+{
+    int rv = 0;
+
+    for (size_t i = 0; (0 == rv) && (i < count); i++) {
+        size_t size = t[i].size(len);
+        uint8_t *o  = alloc(size);
+        uint8_t *e  = alloc(size);
+
+        t[i].fn(raw, len, o);
+        t[i].ref(raw, len, e);
+        rv = differs(t[i].name, len, size, size, o, e);
+        free(o);
+        free(e);
+    }
+
+    return rv;
+}
+
+static int decode_all(const uint8_t *text, size_t len)
+{
+    b64_buf_t buf = { 0 };
+    b64_buf_t ref = { 0 };
+    int rv        = decode_table(frozen_decoders, ARRAY_SIZE(frozen_decoders), text, len);
+
+    if ((0 == rv) && !SELF_REFERENCE) {
+        rv = decode_table(decoders, ARRAY_SIZE(decoders), text, len);
+    }
+    if (0 == rv) {
+        rv = decode_flags_all(text, len);
+    }
+    if ((0 == rv) && !SELF_REFERENCE) {
+        rv = decode_utf16(text, len);
+    }
+    if ((0 == rv) && !SELF_REFERENCE) {
+        b64_decode_append(&buf, text, len);
+        ref_b64_decode_append(&ref, text, len);
+        rv = differs("b64_decode_append", len, buf.len, ref.len, buf.data, ref.data);
+    }
+
+    free(buf.data);
+    free(ref.data);
+
+    return rv;
+}
+
+static int decode_table(const struct decoder *t, size_t count, const uint8_t *text, size_t len)
+{
+    int rv = 0;
+
+    for (size_t i = 0; (0 == rv) && (i < count); i++) {
+        size_t size = t[i].size ? t[i].size(len) : (len / 4) * 3 + 2;
+        uint8_t *o  = alloc(size);
+        uint8_t *e  = alloc(size);
+        size_t got  = t[i].fn(text, len, o);
+        size_t want = t[i].ref(text, len, e);
+
+        rv = differs(t[i].name, len, got, want, o, e);
+        free(o);
+        free(e);
+    }
+
+    return rv;
+}
+
+static int decode_flags_all(const uint8_t *text, size_t len)
+{
+    const size_t combos = ARRAY_SIZE(alphabets) * ARRAY_SIZE(paddings);
+    int rv              = 0;
+
+    /* Each alphabet and padding combination, then all of them again in
+     * constant time.  The chunked decode is a different path from the
+     * reference's b64_decode_flags(), so it is compared in every build. */
+    for (size_t i = 0; (0 == rv) && (i < 2 * combos); i++) {
+        unsigned flags = alphabets[i % ARRAY_SIZE(alphabets)]
+                       | paddings[(i / ARRAY_SIZE(alphabets)) % ARRAY_SIZE(paddings)]
+                       | ((i < combos) ? 0 : B64_DECODE_CONSTANT_TIME);
+        size_t size      = b64_get_decoded_buffer_size_flags(len, flags);
+        uint8_t *o       = alloc(size);
+        uint8_t *e       = alloc(size);
+        struct sink sink = { .data = alloc(size), .size = size };
+        size_t got, want, got_len, want_len;
+        int got_needs, want_needs;
+        uint8_t *got_buf, *want_buf;
+
+        got  = b64_decode_flags(text, len, o, flags);
+        want = ref_b64_decode_flags(text, len, e, flags);
+        if (!SELF_REFERENCE) {
+            rv = differs("b64_decode_flags", len, got, want, o, e);
+        }
+
+        if (0 == rv) {
+            got = b64_decode_chunked(text, len, flags, collect, &sink);
+            rv  = differs("b64_decode_chunked", len, got, want, sink.data, e);
+        }
+        if ((0 == rv) && got && (sink.len != got)) {
+            rv = differs("b64_decode_chunked chunks", len, sink.len, got, NULL, NULL);
+        }
+
+        if ((0 == rv) && !SELF_REFERENCE) {
+            got  = b64_get_decoded_size_flags(text, len, flags, &got_needs);
+            want = ref_b64_get_decoded_size_flags(text, len, flags, &want_needs);
+            rv   = differs("b64_get_decoded_size_flags", len, got, want, NULL, NULL);
+            if (0 == rv) {
+                rv = differs("b64_get_decoded_size_flags needs_decode", len,
+                             (size_t) got_needs, (size_t) want_needs, NULL, NULL);
+            }
+        }
+
+        if ((0 == rv) && !SELF_REFERENCE) {
+            got_buf  = b64_decode_flags_with_alloc(text, len, &got_len, flags);
+            want_buf = ref_b64_decode_flags_with_alloc(text, len, &want_len, flags);
+            rv = differs("b64_decode_flags_with_alloc", len, got_len, want_len, got_buf, want_buf);
+            free(got_buf);
+            free(want_buf);
+        }
+
+        free(o);
+        free(e);
+        free(sink.data);
+    }
+
+    return rv;
+}
+
+/* Decodes the text widened to UTF-16, and again with a code unit that only
+ * matches a base64 character in its low byte. */
+static int decode_utf16(const uint8_t *text, size_t len)
+{
+    uint16_t *wide = alloc(len * sizeof(uint16_t));
+    size_t size    = b64url_get_decoded_buffer_size(len);
+    uint8_t *o     = alloc(size);
+    uint8_t *e     = alloc(size);
+    int rv         = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        wide[i] = text[i];
+    }
+
+    for (int pass = 0; (0 == rv) && (pass < 2); pass++) {
+        if (pass && len) {
+            wide[len / 2] |= 0x4100;
+        }
+        rv = differs("b64_decode_utf16", len, b64_decode_utf16(wide, len, o),
+                     ref_b64_decode_utf16(wide, len, e), o, e);
+        if (0 == rv) {
+            rv = differs("b64url_decode_utf16", len, b64url_decode_utf16(wide, len, o),
+                         ref_b64url_decode_utf16(wide, len, e), o, e);
+        }
+    }
+
+    free(wide);
+    free(o);
+    free(e);
+
+    return rv;
+}
+
+static int decode_corrupted(uint8_t *text, size_t len, unsigned pick)
+{
+    size_t at;
+    uint8_t was;
+    int rv;
+
+    if (0 == len) {
+        return 0;
+    }
+
+    at       = ((size_t) pick * len) >> 8;
+    was      = text[at];
+    text[at] = corruptions[pick % ARRAY_SIZE(corruptions)];
+    rv       = decode_all(text, len);
+    text[at] = was;
+
+    return rv;
+}
+
+/* Stops the decode rather than write past the documented size. */
+static int collect(const uint8_t *raw, size_t len, void *user)
+{
+    struct sink *s = user;
+
+    if ((0 == len) || (B64_DECODE_CHUNK_MAX < len) || (s->size - s->len < len)) {
+        return -1;
+    }
+    memcpy(&s->data[s->len], raw, len);
+    s->len += len;
+
+    return 0;
+}
+
+/* Compares the return values, then the output bytes they cover unless out is
+ * NULL. */
+static int differs(const char *path, size_t len, size_t got, size_t want, const void *out,
+                   const void *ref)
+{
+    if ((got == want) && (!out || (0 == got) || (0 == memcmp(out, ref, got)))) {
+        return 0;
+    }
+
+    fprintf(stderr, "%s: %s(%zu bytes) returned %zu where the reference returned %zu",
+            diff_kernel(), path, len, got, want);
+    if (got == want) {
+        fprintf(stderr, ", with different output");
+    }
+    fprintf(stderr, "\n");
+
+    return -1;
+}
+
+/* Exactly sized, so a sanitizer sees any write past the documented size.
+ * Running out of memory here means the fuzzer is misconfigured. */
+static void *alloc(size_t size)
+{
+    void *p = malloc(size ? size : 1);
+
+    if (!p) {
+        fprintf(stderr, "out of memory allocating %zu bytes\n", size);
+        abort();
+    }
+
+    return p;
+}
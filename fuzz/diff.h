@@ -0,0 +1,35 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+#ifndef __BASE64_FUZZ_DIFF__
+#define __BASE64_FUZZ_DIFF__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Get the name of the kernel the codec under test was built with.
+ *
+ * @return "scalar", "swar" or "tablefree"
+ */
+const char *diff_kernel(void);
+
+
+/**
+ * Compares every one shot path of the codec under test with the reference.
+ * The rest of the input after the first byte is encoded by every encoder and
+ * decoded as text by every decoder with every flag combination.  Its valid
+ * encodings are decoded as well, as is a copy of each with one character
+ * replaced.  The first byte picks the character and where it goes.
+ *
+ * @note: The output buffers are exactly the documented size, so a sanitizer
+ *        also catches a kernel writing past them.
+ *
+ * @param data  the fuzz input
+ * @param len   the length of the fuzz input
+ *
+ * @return 0 if everything matched, or -1 after printing the first difference
+ *         to stderr
+ */
+int diff_input(const uint8_t *data, size_t len);
+
+#endif /* __BASE64_FUZZ_DIFF__ */
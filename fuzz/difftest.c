@@ -0,0 +1,511 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/* Randomized differential test of the kernel this is built with against the
+ * scalar references (see reference.h).
+ *
+ *   difftest [--seed N] [--iterations N] [--max-len N] [--throughput MiB]
+ *
+ * Random inputs go through every one shot path with diff_input(), then
+ * through the streaming (b64_encode_fd()/b64_decode_fd() and
+ * b64_decode_chunked()) and batch (async pool) paths.  Last, as a side
+ * output, it prints the throughput of the kernel and of the reference (0 MiB
+ * skips it).
+ *
+ * The exit code is 0 when everything matched the reference.  A failure
+ * prints the seed, so the run can be repeated.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "async.h"
+#include "base16.h"
+#include "base32.h"
+#include "base64.h"
+#include "diff.h"
+#include "fd.h"
+#include "reference.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                   Macros                                   */
+/*----------------------------------------------------------------------------*/
+
+/* The streams straddle the 192 KiB blocks the fd functions read in. */
+#define STREAMS        24
+#define STREAM_MAX_LEN (3 * 192 * 1024 + 7)
+
+#define JOBS        16
+#define JOB_MAX_LEN (1024 * 1024)
+
+/* The throughput is measured on this much data at a time. */
+#define THROUGHPUT_BLOCK (1024 * 1024)
+
+/*----------------------------------------------------------------------------*/
+/*                               Data Structures                              */
+/*----------------------------------------------------------------------------*/
+typedef void (*encode_fn)(const uint8_t *, const size_t, uint8_t *);
+typedef size_t (*decode_fn)(const uint8_t *, const size_t, uint8_t *);
+
+/* What b64_decode_chunked() must hand over, in order. */
+struct expect {
+    const uint8_t *data;
+    size_t len;
+    size_t at;
+};
+
+struct speed {
+    const char *name;
+    encode_fn encode, ref_encode;
+    decode_fn decode, ref_decode;
+    size_t (*size)(const size_t);
+};
+
+/*----------------------------------------------------------------------------*/
+/*                            File Scoped Variables                           */
+/*----------------------------------------------------------------------------*/
+// clang-format off
+static const struct speed speeds[] = {
+    { "b64",    b64_encode,    ref_b64_encode,    b64_decode,    ref_b64_decode,    b64_get_encoded_buffer_size    },
+    { "b64url", b64url_encode, ref_b64url_encode, b64url_decode, ref_b64url_decode, b64url_get_encoded_buffer_size },
+    { "b16",    b16_encode,    ref_b16_encode,    b16_decode,    ref_b16_decode,    b16_get_encoded_buffer_size    },
+    { "b32",    b32_encode,    ref_b32_encode,    b32_decode,    ref_b32_decode,    b32_get_encoded_buffer_size    },
+};
+// clang-format on
+
+/* The flags the streams are decoded with. */
+static const unsigned stream_flags[] = {
+    B64_DECODE_STANDARD | B64_DECODE_PAD_REQUIRED,
+    B64_DECODE_STANDARD | B64_DECODE_PAD_OPTIONAL,
+    B64_DECODE_URL | B64_DECODE_PAD_FORBIDDEN,
+    B64_DECODE_ANY_ALPHABET | B64_DECODE_PAD_OPTIONAL,
+    B64_DECODE_STANDARD | B64_DECODE_PAD_REQUIRED | B64_DECODE_CONSTANT_TIME,
+};
+
+static uint64_t state;
+
+/*----------------------------------------------------------------------------*/
+/*                             Function Prototypes                            */
+/*----------------------------------------------------------------------------*/
+static uint64_t next(void);
+static size_t random_len(size_t max);
+static uint8_t *random_bytes(size_t len);
+static void corrupt(uint8_t *text, size_t len);
+static int check_inputs(size_t iterations, size_t max_len);
+static int check_streams(void);
+static int check_stream(const uint8_t *raw, size_t len);
+static int match(const uint8_t *raw, size_t len, void *user);
+static int check_jobs(void);
+static void throughput(size_t mib);
+static double seconds(void);
+static int file_with(const uint8_t *data, size_t len);
+static uint8_t *file_contents(int fd, size_t *len);
+static void *alloc(size_t size);
+
+/*----------------------------------------------------------------------------*/
+/*                             External Functions                             */
+/*----------------------------------------------------------------------------*/
+int main(int argc, char *argv[])
+{
+    uint64_t seed     = (uint64_t) time(NULL);
+    size_t iterations = 20000;
+    size_t max_len    = 1024;
+    size_t mib        = 64;
+    int rv;
+
+    for (int i = 1; i < argc; i++) {
+        if ((0 == strcmp("--seed", argv[i])) && (i + 1 < argc)) {
+            seed = strtoull(argv[++i], NULL, 0);
+        } else if ((0 == strcmp("--iterations", argv[i])) && (i + 1 < argc)) {
+            iterations = (size_t) strtoull(argv[++i], NULL, 0);
+        } else if ((0 == strcmp("--max-len", argv[i])) && (i + 1 < argc)) {
+            max_len = (size_t) strtoull(argv[++i], NULL, 0);
+        } else if ((0 == strcmp("--throughput", argv[i])) && (i + 1 < argc)) {
+            mib = (size_t) strtoull(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [--seed N] [--iterations N] [--max-len N] "
+                            "[--throughput MiB]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* xorshift can't start from 0. */
+    state = seed ? seed : 1;
+
+    printf("%s kernel, seed %llu\n", diff_kernel(), (unsigned long long) seed);
+
+    rv = check_inputs(iterations, max_len);
+    if (0 == rv) {
+        rv = check_streams();
+    }
+    if (0 == rv) {
+        rv = check_jobs();
+    }
+    if (0 != rv) {
+        printf("FAILED: the %s kernel differs from the reference, seed %llu\n", diff_kernel(),
+               (unsigned long long) seed);
+        return EXIT_FAILURE;
+    }
+
+    printf("%zu inputs, %d streams and %d jobs matched the reference\n", iterations, STREAMS,
+           JOBS);
+
+    if (mib) {
+        throughput(mib);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                             Internal functions                             */
+/*----------------------------------------------------------------------------*/
+
+/* xorshift64*, so a seed means the same inputs on every platform. */
+static uint64_t next(void)
+{
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+
+    return state * 0x2545f4914f6cdd1dULL;
+}
+
+/* Mostly short lengths, where the kernels hand over to the tail loops, with
+ * the occasional long one. */
+static size_t random_len(size_t max)
+{
+    size_t limit = (next() & 3) ? 40 : max;
+
+    return (size_t) (next() % (limit + 1));
+}
+
+static uint8_t *random_bytes(size_t len)
+{
+    uint8_t *p = alloc(len);
+
+    for (size_t i = 0; i < len; i++) {
+        p[i] = (uint8_t) next();
+    }
+
+    return p;
+}
+
+/* Replaces one character with anything at all, half of the time. */
+static void corrupt(uint8_t *text, size_t len)
+{
+    if (len && (next() & 1)) {
+        text[next() % len] = (uint8_t) next();
+    }
+}
+
+static int check_inputs(size_t iterations, size_t max_len)
+{
+    static const char text[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/-_=";
+
+    for (size_t i = 0; i < iterations; i++) {
+        size_t len   = random_len(max_len);
+        uint8_t *buf = random_bytes(len);
+        int rv;
+
+        /* Some inputs are made of the encoding characters only, so the text
+         * decoded directly is sometimes valid too. */
+        if (next() & 1) {
+            for (size_t j = 1; j < len; j++) {
+                buf[j] = (uint8_t) text[buf[j] % (sizeof(text) - 1)];
+            }
+        }
+
+        rv = diff_input(buf, len);
+        free(buf);
+        if (0 != rv) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int check_streams(void)
+{
+    for (int i = 0; i < STREAMS; i++) {
+        size_t len   = (size_t) (next() % (STREAM_MAX_LEN + 1));
+        uint8_t *raw = random_bytes(len);
+        int rv       = check_stream(raw, len);
+
+        free(raw);
+        if (0 != rv) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/* Encodes the bytes from a file and compares the result with the reference,
+ * then decodes the reference's (maybe corrupted) encoding from a file. */
+static int check_stream(const uint8_t *raw, size_t len)
+{
+    int url        = (int) (next() & 1);
+    unsigned flags = stream_flags[next() % (sizeof(stream_flags) / sizeof(stream_flags[0]))];
+    size_t enc_len = url ? b64url_get_encoded_buffer_size(len) : b64_get_encoded_buffer_size(len);
+    uint8_t *want  = alloc(enc_len);
+    uint8_t *dec   = alloc(len);
+    int in         = file_with(raw, len);
+    int out        = file_with(NULL, 0);
+    size_t dec_len = 0;
+    uint8_t *got   = NULL;
+    size_t got_len = 0;
+    int rv         = -1;
+    struct expect x;
+    int ok;
+
+    if (url) {
+        ref_b64url_encode(raw, len, want);
+    } else {
+        ref_b64_encode(raw, len, want);
+    }
+
+    if ((in < 0) || (out < 0)) {
+        fprintf(stderr, "unable to create the stream files\n");
+        goto done;
+    }
+
+    if ((0 != b64_encode_fd(in, out, url ? B64_ENCODE_URL : B64_ENCODE_STANDARD))
+        || !(got = file_contents(out, &got_len)) || (got_len != enc_len)
+        || (0 != memcmp(got, want, enc_len)))
+    {
+        fprintf(stderr, "%s: b64_encode_fd(%zu bytes, %s) differs from the reference\n",
+                diff_kernel(), len, url ? "url" : "standard");
+        goto done;
+    }
+    free(got);
+    got = NULL;
+    close(in);
+    close(out);
+
+    corrupt(want, enc_len);
+    in  = file_with(want, enc_len);
+    out = file_with(NULL, 0);
+    if ((in < 0) || (out < 0)) {
+        fprintf(stderr, "unable to create the stream files\n");
+        goto done;
+    }
+
+    /* Empty input is the one place the stream accepts what a one shot decode
+     * rejects. */
+    dec_len = ref_b64_decode_flags(want, enc_len, dec, flags);
+    ok      = (0 == b64_decode_fd(in, out, flags));
+    if ((ok != ((0 == enc_len) || (0 != dec_len))) || !(got = file_contents(out, &got_len))
+        || (ok && ((got_len != dec_len) || (0 != memcmp(got, dec, dec_len)))))
+    {
+        fprintf(stderr, "%s: b64_decode_fd(%zu bytes, flags 0x%04x) differs from the reference\n",
+                diff_kernel(), enc_len, flags);
+        goto done;
+    }
+
+    /* The chunks of a long stream end on every possible group boundary. */
+    x.data  = dec;
+    x.len   = dec_len;
+    x.at    = 0;
+    got_len = b64_decode_chunked(want, enc_len, flags, match, &x);
+    if ((got_len != dec_len) || (got_len && (x.at != got_len))) {
+        fprintf(stderr, "%s: b64_decode_chunked(%zu bytes, flags 0x%04x) returned %zu where the "
+                        "reference returned %zu\n",
+                diff_kernel(), enc_len, flags, got_len, dec_len);
+        goto done;
+    }
+
+    rv = 0;
+
+done:
+    if (0 <= in) {
+        close(in);
+    }
+    if (0 <= out) {
+        close(out);
+    }
+    free(got);
+    free(want);
+    free(dec);
+
+    return rv;
+}
+
+/* Fails on any chunk that doesn't match the reference's output. */
+static int match(const uint8_t *raw, size_t len, void *user)
+{
+    struct expect *x = user;
+
+    if ((x->len - x->at < len) || (0 != memcmp(raw, &x->data[x->at], len))) {
+        return -1;
+    }
+    x->at += len;
+
+    return 0;
+}
+
+static int check_jobs(void)
+{
+    b64_pool_t *pool = b64_pool_create(NULL);
+    int rv           = 0;
+
+    if (!pool) {
+        fprintf(stderr, "unable to create the pool\n");
+        return -1;
+    }
+
+    for (int i = 0; (0 == rv) && (i < JOBS); i++) {
+        size_t len     = 1 + (size_t) (next() % JOB_MAX_LEN);
+        size_t enc_len = b64_get_encoded_buffer_size(len);
+        uint8_t *raw   = random_bytes(len);
+        uint8_t *enc   = alloc(enc_len);
+        uint8_t *want  = alloc(enc_len);
+        uint8_t *dec   = alloc(len);
+        uint8_t *ref   = alloc(len);
+        size_t got, exp;
+        b64_job_t *job;
+
+        ref_b64_encode(raw, len, want);
+        job = b64_encode_async(pool, raw, len, enc, NULL, NULL, -1);
+        got = b64_job_wait(job);
+        b64_job_free(job);
+        if ((enc_len != got) || (0 != memcmp(enc, want, enc_len))) {
+            fprintf(stderr, "%s: b64_encode_async(%zu bytes) differs from the reference\n",
+                    diff_kernel(), len);
+            rv = -1;
+        }
+
+        corrupt(want, enc_len);
+        exp = ref_b64_decode(want, enc_len, ref);
+        job = b64_decode_async(pool, want, enc_len, dec, NULL, NULL, -1);
+        got = b64_job_wait(job);
+        b64_job_free(job);
+        if ((0 == rv) && ((exp != got) || (0 != memcmp(dec, ref, got)))) {
+            fprintf(stderr, "%s: b64_decode_async(%zu bytes) returned %zu where the reference "
+                            "returned %zu\n", diff_kernel(), enc_len, got, exp);
+            rv = -1;
+        }
+
+        free(raw);
+        free(enc);
+        free(want);
+        free(dec);
+        free(ref);
+    }
+
+    b64_pool_destroy(pool);
+
+    return rv;
+}
+
+static void throughput(size_t mib)
+{
+    uint8_t *raw = random_bytes(THROUGHPUT_BLOCK);
+    uint8_t *enc = alloc(b16_get_encoded_buffer_size(THROUGHPUT_BLOCK));
+    uint8_t *dec = alloc(THROUGHPUT_BLOCK);
+
+    printf("%-14s %12s %12s %8s\n", "MiB/s", diff_kernel(), "reference", "speedup");
+
+    for (size_t i = 0; i < sizeof(speeds) / sizeof(speeds[0]); i++) {
+        const struct speed *s = &speeds[i];
+        size_t enc_len        = s->size(THROUGHPUT_BLOCK);
+        double t[4];
+
+        for (int pass = 0; pass < 4; pass++) {
+            double start = seconds();
+
+            for (size_t n = 0; n < mib; n++) {
+                switch (pass) {
+                    case 0:
+                        s->encode(raw, THROUGHPUT_BLOCK, enc);
+                        break;
+                    case 1:
+                        s->ref_encode(raw, THROUGHPUT_BLOCK, enc);
+                        break;
+                    case 2:
+                        s->decode(enc, enc_len, dec);
+                        break;
+                    default:
+                        s->ref_decode(enc, enc_len, dec);
+                        break;
+                }
+            }
+            t[pass] = seconds() - start;
+        }
+
+        printf("%-14s %12.1f %12.1f %7.2fx\n", s->name, (double) mib / t[0],
+               (double) mib / t[1], t[1] / t[0]);
+        printf("%-14s %12.1f %12.1f %7.2fx\n", "  decode", (double) mib / t[2],
+               (double) mib / t[3], t[3] / t[2]);
+    }
+
+    free(raw);
+    free(enc);
+    free(dec);
+}
+
+static double seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+/* Returns an unlinked temporary file holding the data, positioned at 0. */
+static int file_with(const uint8_t *data, size_t len)
+{
+    char name[] = "/tmp/b64-diff-XXXXXX";
+    int fd      = mkstemp(name);
+
+    if (0 <= fd) {
+        unlink(name);
+        if ((len && ((ssize_t) len != write(fd, data, len))) || (0 != lseek(fd, 0, SEEK_SET))) {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    return fd;
+}
+
+/* Reads back everything in the file. */
+static uint8_t *file_contents(int fd, size_t *len)
+{
+    off_t size    = lseek(fd, 0, SEEK_END);
+    uint8_t *data = alloc((size_t) size);
+    size_t got    = 0;
+
+    lseek(fd, 0, SEEK_SET);
+    while (got < (size_t) size) {
+        ssize_t n = read(fd, &data[got], (size_t) size - got);
+
+        if (n <= 0) {
+            break;
+        }
+        got += (size_t) n;
+    }
+    *len = got;
+
+    return data;
+}
+
+static void *alloc(size_t size)
+{
+    void *p = malloc(size ? size : 1);
+
+    if (!p) {
+        fprintf(stderr, "out of memory allocating %zu bytes\n", size);
+        exit(EXIT_FAILURE);
+    }
+
+    return p;
+}
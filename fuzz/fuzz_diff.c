@@ -0,0 +1,98 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/* The differential fuzz target: every input runs through diff_input() and a
+ * difference from the reference aborts, so the fuzzer keeps the input.
+ *
+ * Built with -DB64_FUZZ_LIBFUZZER and -fsanitize=fuzzer it is a libFuzzer
+ * target.  Otherwise it has its own main(): under afl-clang-fast it runs in
+ * AFL++'s shared memory persistent mode, and elsewhere it replays the files
+ * named on the command line (or stdin), for example a crash or a corpus. */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "diff.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                   Macros                                   */
+/*----------------------------------------------------------------------------*/
+
+/* Inputs are cut off here; longer ones only make each run slower. */
+#define MAX_INPUT (64 * 1024)
+
+/*----------------------------------------------------------------------------*/
+/*                             Function Prototypes                            */
+/*----------------------------------------------------------------------------*/
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+/*----------------------------------------------------------------------------*/
+/*                             External Functions                             */
+/*----------------------------------------------------------------------------*/
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    if (MAX_INPUT < size) {
+        size = MAX_INPUT;
+    }
+    if (0 != diff_input(data, size)) {
+        abort();
+    }
+
+    return 0;
+}
+
+
+#if !defined(B64_FUZZ_LIBFUZZER)
+
+#if defined(__AFL_FUZZ_TESTCASE_LEN)
+
+__AFL_FUZZ_INIT();
+
+int main(void)
+{
+    const uint8_t *buf;
+
+    __AFL_INIT();
+    buf = __AFL_FUZZ_TESTCASE_BUF;
+
+    while (__AFL_LOOP(10000)) {
+        LLVMFuzzerTestOneInput(buf, (size_t) __AFL_FUZZ_TESTCASE_LEN);
+    }
+
+    return 0;
+}
+
+#else
+
+static void replay(FILE *f)
+{
+    static uint8_t buf[MAX_INPUT];
+
+    LLVMFuzzerTestOneInput(buf, fread(buf, 1, sizeof(buf), f));
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        replay(stdin);
+        return 0;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        FILE *f = fopen(argv[i], "rb");
+
+        if (!f) {
+            perror(argv[i]);
+            return EXIT_FAILURE;
+        }
+        replay(f);
+        fclose(f);
+    }
+
+    return 0;
+}
+
+#endif
+
+#endif
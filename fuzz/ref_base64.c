@@ -0,0 +1,9 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/* The scalar reference build of base64.c, see reference.h. */
+#define REFERENCE_BUILD
+
+#include "reference.h"
+
+#include "../src/base64.c"
@@ -0,0 +1,18 @@
+#!/bin/sh
+# SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC
+# SPDX-License-Identifier: Apache-2.0
+#
+# Writes ref_names.h for fuzz/reference.h: a #define that renames each
+# external symbol the reference objects define to ref_<symbol>.
+#
+#   ref_names.sh <nm program> <output header> <object or library> [...]
+
+nm_bin=$1
+out=$2
+shift 2
+
+{
+    echo '/* Generated by fuzz/ref_names.sh; do not edit. */'
+    "$nm_bin" -g "$@" | awk 'NF == 3 && $2 != "U" { print $3 }' | sort -u |
+        awk '{ printf "#define %-40s ref_%s\n", $1, $1 }'
+} > "$out"
@@ -0,0 +1,71 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+#ifndef __BASE64_FUZZ_REFERENCE__
+#define __BASE64_FUZZ_REFERENCE__
+
+/* There are two references.  The ref_*.c files build the current codec
+ * sources a second time, next to the kernel under test, with the scalar
+ * loops and every external symbol renamed ref_*.  They cover every path, but
+ * in the scalar build they are the code under test, so diff.c skips those
+ * comparisons there.  frozen_base64.c is the scalar codec from before any of
+ * the kernels, and every build, scalar included, is compared with it for the
+ * functions it has.
+ *
+ * ref_names.h holds the renames.  The build generates it with
+ * fuzz/ref_names.sh from the symbols nm finds in the ref_*.c files compiled
+ * with REFERENCE_SCAN defined, so functions added to the sources are picked
+ * up without any list to keep. */
+
+#ifdef REFERENCE_BUILD
+
+#undef B64_KERNEL_SWAR
+#undef B64_KERNEL_TABLEFREE
+#undef B64_STATS
+
+#ifndef REFERENCE_SCAN
+#include "ref_names.h"
+#endif
+
+#else
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base64.h"
+
+/* The reference functions the differential checks compare against. */
+void ref_b64_encode(const uint8_t *raw, const size_t len, uint8_t *out);
+void ref_b64url_encode(const uint8_t *raw, const size_t len, uint8_t *out);
+void ref_b64_encode_utf16(const uint8_t *raw, const size_t len, uint16_t *out);
+void ref_b64url_encode_utf16(const uint8_t *raw, const size_t len, uint16_t *out);
+size_t ref_b64_decode(const uint8_t *enc, const size_t len, uint8_t *out);
+size_t ref_b64url_decode(const uint8_t *enc, const size_t len, uint8_t *out);
+size_t ref_b64_decode_flags(const uint8_t *enc, const size_t len, uint8_t *out, unsigned flags);
+size_t ref_b64_decode_json(const uint8_t *enc, const size_t len, uint8_t *out);
+size_t ref_b64url_decode_json(const uint8_t *enc, const size_t len, uint8_t *out);
+size_t ref_b64_decode_utf16(const uint16_t *enc, const size_t len, uint8_t *out);
+size_t ref_b64url_decode_utf16(const uint16_t *enc, const size_t len, uint8_t *out);
+size_t ref_b64_get_decoded_size(const uint8_t *enc, size_t len, int *needs_decode);
+size_t ref_b64url_get_decoded_size(const uint8_t *enc, size_t len, int *needs_decode);
+size_t ref_b64_get_decoded_size_flags(const uint8_t *enc, size_t len, unsigned flags,
+                                      int *needs_decode);
+uint8_t *ref_b64_decode_flags_with_alloc(const uint8_t *enc, size_t len, size_t *out_len,
+                                         unsigned flags);
+size_t ref_b64_encode_append(b64_buf_t *dst, const uint8_t *raw, size_t len);
+size_t ref_b64_decode_append(b64_buf_t *dst, const uint8_t *enc, size_t len);
+void ref_b16_encode(const uint8_t *raw, const size_t len, uint8_t *out);
+size_t ref_b16_decode(const uint8_t *enc, const size_t len, uint8_t *out);
+void ref_b32_encode(const uint8_t *raw, const size_t len, uint8_t *out);
+size_t ref_b32_decode(const uint8_t *enc, const size_t len, uint8_t *out);
+void ref_b32hex_encode(const uint8_t *raw, const size_t len, uint8_t *out);
+size_t ref_b32hex_decode(const uint8_t *enc, const size_t len, uint8_t *out);
+
+/* The frozen codec. */
+void frozen_b64_encode(const uint8_t *raw, const size_t len, uint8_t *out);
+void frozen_b64url_encode(const uint8_t *raw, const size_t len, uint8_t *out);
+size_t frozen_b64_decode(const uint8_t *enc, const size_t len, uint8_t *out);
+size_t frozen_b64url_decode(const uint8_t *enc, const size_t len, uint8_t *out);
+
+#endif
+
+#endif /* __BASE64_FUZZ_REFERENCE__ */
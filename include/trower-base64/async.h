@@ -0,0 +1,151 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+#ifndef __BASE64_ASYNC__
+#define __BASE64_ASYNC__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*----------------------------------------------------------------------------*/
+/*                              Asynchronous Jobs                             */
+/*----------------------------------------------------------------------------*/
+
+/* Runs b64_encode() and b64_decode() on a pool of worker threads so an event
+ * loop never blocks on a large buffer.
+ *
+ * Jobs are split into quanta (chunks of 'quantum' raw bytes) and the workers
+ * take turns at the quanta of every queued job, so a small job queued behind
+ * a large one waits for at most about one quantum per worker, not for the
+ * whole large job.  Idle workers steal from busy ones, so a single large job
+ * is spread over the whole pool. */
+
+typedef struct b64_pool b64_pool_t;
+typedef struct b64_job b64_job_t;
+
+/**
+ * Called on a worker thread once a job has completed, before b64_job_wait()
+ * returns for it.  The callback may call b64_job_result() and b64_job_free()
+ * but should not block.
+ */
+typedef void (*b64_job_cb_t)(b64_job_t *job, void *user);
+
+typedef struct {
+    size_t workers; /* worker threads, 0 for one per online CPU */
+    size_t quantum; /* raw bytes per quantum (rounded down to a multiple of 3),
+                     * 0 for the default of 48 KiB */
+} b64_pool_config_t;
+
+
+/**
+ * Creates a worker pool.
+ *
+ * @param config  the pool settings, or NULL for the defaults
+ *
+ * @return the pool, or NULL on error
+ */
+b64_pool_t *b64_pool_create(const b64_pool_config_t *config);
+
+
+/**
+ * Waits for every submitted job to complete, then stops the workers and
+ * frees the pool.  Jobs that haven't been freed are still valid afterwards.
+ *
+ * @param pool  the pool to free (NULL is ignored)
+ */
+void b64_pool_destroy(b64_pool_t *pool);
+
+
+/**
+ * Queues a b64_encode() of the raw bytes.
+ *
+ * @note: The input and output buffers must stay valid and untouched until the
+ *        job has completed.  The output buffer must hold
+ *        b64_get_encoded_buffer_size(len) bytes.
+ *
+ * @param pool       the pool to run the job on
+ * @param raw        the raw bytes to encode
+ * @param len        the number of raw bytes (must be > 0 and no more than
+ *                   B64_MAX_ENCODE_LEN)
+ * @param out        the output buffer
+ * @param cb         if not NULL, called when the job completes
+ * @param user       passed to the callback
+ * @param notify_fd  if >= 0, an eventfd(2) (or pipe) that is written an 8 byte
+ *                   1 when the job completes, after the callback
+ *
+ * @return the job, or NULL on error
+ */
+b64_job_t *b64_encode_async(b64_pool_t *pool, const uint8_t *raw, size_t len, uint8_t *out,
+                            b64_job_cb_t cb, void *user, int notify_fd);
+
+
+/**
+ * Queues a b64_decode() of the encoded bytes.  The result is the same as the
+ * synchronous call, including rejecting padding anywhere but the end.
+ *
+ * @note: The input and output buffers must stay valid and untouched until the
+ *        job has completed.  The output buffer must hold
+ *        b64_get_decoded_buffer_size(len) bytes, and is undefined if the
+ *        decode fails.
+ *
+ * @param pool       the pool to run the job on
+ * @param enc        the encoded bytes to decode
+ * @param len        the number of encoded bytes (must be > 0)
+ * @param out        the output buffer
+ * @param cb         if not NULL, called when the job completes
+ * @param user       passed to the callback
+ * @param notify_fd  if >= 0, an eventfd(2) (or pipe) that is written an 8 byte
+ *                   1 when the job completes, after the callback
+ *
+ * @return the job, or NULL on error
+ */
+b64_job_t *b64_decode_async(b64_pool_t *pool, const uint8_t *enc, size_t len, uint8_t *out,
+                            b64_job_cb_t cb, void *user, int notify_fd);
+
+
+/**
+ * Returns non-zero once the job has completed (and its callback returned).
+ *
+ * @param job  the job
+ */
+int b64_job_done(const b64_job_t *job);
+
+
+/**
+ * Blocks until the job has completed.
+ *
+ * @param job  the job
+ *
+ * @return the same as b64_job_result()
+ */
+size_t b64_job_wait(b64_job_t *job);
+
+
+/**
+ * Returns the number of bytes the job wrote to its output buffer.
+ *
+ * @param job  the job
+ *
+ * @return the output size, or 0 if the job failed or hasn't completed
+ */
+size_t b64_job_result(const b64_job_t *job);
+
+
+/**
+ * Releases the job.  This may be called at any time, including from the
+ * callback; a job that hasn't completed still runs (and notifies) and is freed
+ * when it does.  The job must not be used afterwards.
+ *
+ * @param job  the job to free (NULL is ignored)
+ */
+void b64_job_free(b64_job_t *job);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BASE64_ASYNC__ */
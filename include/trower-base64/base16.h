@@ -0,0 +1,154 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+#ifndef __BASE64_BASE16__
+#define __BASE64_BASE16__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base64.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                 Base16 (hex)                               */
+/*----------------------------------------------------------------------------*/
+
+/* Base16 (RFC 4648) is encoded in lower case, the usual spelling of hashes,
+ * and decoded in either case.  These use the same codec kernel as base64. */
+
+/* The longest input that can be encoded, like B64_MAX_ENCODE_LEN. */
+#define B16_MAX_ENCODE_LEN (SIZE_MAX / 2)
+
+/**
+ * Get the size of the buffer required to hold the hex encoded data.
+ *
+ * @note: The size returned does not account for any trailing '\0'.
+ *
+ * @param decoded_size size of the decoded data
+ *
+ * @return size of the buffer required to hold the encoded data
+ */
+size_t b16_get_encoded_buffer_size(const size_t decoded_size);
+
+
+/**
+ * The same as b16_get_encoded_buffer_size(), but reports inputs whose encoded
+ * size doesn't fit in a size_t instead of wrapping around.
+ *
+ * @param decoded_size size of the decoded data
+ * @param overflow     if not NULL, set to 1 if the size doesn't fit, or 0
+ *                     otherwise
+ *
+ * @return size of the buffer required to hold the encoded data, or 0 if it
+ *         doesn't fit
+ */
+size_t b16_get_encoded_buffer_size_checked(const size_t decoded_size, int *overflow);
+
+
+/**
+ * Get the size of the buffer needed to hold the decoded output.  Every hex
+ * input decodes to exactly this many bytes.
+ *
+ * @param encoded_size size of the encoded data
+ *
+ * @return size of the raw data, or 0 if the length is odd
+ */
+size_t b16_get_decoded_buffer_size(const size_t encoded_size);
+
+
+/**
+ * Encodes the input into lower case hex.
+ *
+ * @note: The output buffer must hold b16_get_encoded_buffer_size(len) bytes.
+ *        It is not '\0' terminated.
+ *
+ * @param raw  pointer to the raw data
+ * @param len  size of the raw data in bytes
+ * @param out  pointer to where the encoded data should be placed
+ */
+void b16_encode(const uint8_t *raw, const size_t len, uint8_t *out);
+
+
+/**
+ * Decodes hex of either case.
+ *
+ * @note: The output buffer must hold b16_get_decoded_buffer_size(len) bytes.
+ *
+ * @param enc  pointer to the encoded data
+ * @param len  size of the encoded data
+ * @param out  pointer to where the decoded data should be placed
+ *
+ * @return total number of bytes in the decoded array, or 0 if there was a
+ *         decoding error
+ */
+size_t b16_decode(const uint8_t *enc, const size_t len, uint8_t *out);
+
+
+/**
+ * Decodes the hex buffer into a new buffer with the size specified in
+ * out_len.
+ *
+ * @note: The returned buffer must have free() called to prevent a memory
+ *        leak.
+ *
+ * @param enc      pointer to the encoded data
+ * @param len      size of the encoded data
+ * @param out_len  pointer to where the resulting buffer length is placed
+ *
+ * @return the buffer containing the raw bytes or NULL on error
+ */
+uint8_t *b16_decode_with_alloc(const uint8_t *enc, size_t len, size_t *out_len);
+
+
+/**
+ * Encodes the raw bytes into a new '\0' terminated hex string.
+ *
+ * @note: The returned buffer must have free() called to prevent a memory
+ *        leak.
+ *
+ * @param raw      pointer to the raw data
+ * @param len      size of the raw data in bytes
+ * @param out_len  if not NULL, the length of the string (without the '\0')
+ *
+ * @return the encoded string or NULL on error
+ */
+char *b16_encode_with_alloc(const uint8_t *raw, size_t len, size_t *out_len);
+
+
+/**
+ * Encodes the raw bytes as hex directly onto the end of the buffer, the same
+ * way b64_encode_append() does.
+ *
+ * @note: The buffer is not '\0' terminated.
+ *
+ * @param dst  pointer to the buffer to append to
+ * @param raw  pointer to the raw data
+ * @param len  size of the raw data in bytes
+ *
+ * @return number of bytes appended, or 0 if there was an error (the buffer
+ *         contents are left unchanged)
+ */
+size_t b16_encode_append(b64_buf_t *dst, const uint8_t *raw, size_t len);
+
+
+/**
+ * Decodes the hex directly onto the end of the buffer.
+ *
+ * @param dst  pointer to the buffer to append to
+ * @param enc  pointer to the encoded data
+ * @param len  size of the encoded data
+ *
+ * @return number of bytes appended, or 0 if there was a decoding error (the
+ *         buffer contents are left unchanged)
+ */
+size_t b16_decode_append(b64_buf_t *dst, const uint8_t *enc, size_t len);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BASE64_BASE16__ */
@@ -14,10 +14,19 @@ extern "C" {
 /*                             Standard Base64                                */
 /*----------------------------------------------------------------------------*/
 
+/* The longest input that can be encoded: the encoded size of anything longer
+ * doesn't fit in a size_t.  The encoded size of this many bytes, plus a '\0',
+ * always does.  The *_with_alloc() and *_append() encoders reject longer
+ * input. */
+#define B64_MAX_ENCODE_LEN ((SIZE_MAX / 4) * 3)
+
 /**
  *  Get the size of the buffer required to hold the decoded data when encoded.
  *
- *  @note: The size returned does not account for any trailing '\0'.
+ *  @note: The size returned does not account for any trailing '\0'.  It
+ *         wraps around for inputs longer than B64_MAX_ENCODE_LEN; use
+ *         b64_get_encoded_buffer_size_checked() when the length is not
+ *         already bounded.
  *
  *  @param decoded_size size of the decoded date
  *
@@ -26,6 +35,20 @@ extern "C" {
 size_t b64_get_encoded_buffer_size(const size_t decoded_size);
 
 
+/**
+ * The same as b64_get_encoded_buffer_size(), but reports inputs whose encoded
+ * size doesn't fit in a size_t instead of wrapping around.
+ *
+ * @param decoded_size size of the decoded data
+ * @param overflow     if not NULL, set to 1 if the size doesn't fit, or 0
+ *                     otherwise
+ *
+ * @return size of the buffer required to hold the encoded data, or 0 if it
+ *         doesn't fit
+ */
+size_t b64_get_encoded_buffer_size_checked(const size_t decoded_size, int *overflow);
+
+
 /**
  * Get the size of the buffer needed to hold the decoded output.
  *
@@ -38,6 +61,24 @@ size_t b64_get_encoded_buffer_size(const size_t decoded_size);
 size_t b64_get_decoded_buffer_size(const size_t encoded_size);
 
 
+/**
+ * Get the exact number of bytes b64_decode() will write for the input, by
+ * looking at the length and the final 4 character group only.
+ *
+ * @note: Only the final group is validated.  If needs_decode is set to 1 the
+ *        rest of the input hasn't been checked, and b64_decode() may still
+ *        reject it; if it is set to 0 the whole input is known to be valid.
+ *
+ * @param enc          pointer to the encoded data
+ * @param len          length of the encoded data
+ * @param needs_decode if not NULL, set to 1 if the size alone doesn't prove the
+ *                     input is valid, or 0 otherwise
+ *
+ * @return the exact size of the raw data, or 0 if the input is invalid
+ */
+size_t b64_get_decoded_size(const uint8_t *enc, size_t len, int *needs_decode);
+
+
 /**
  *  Encodes the input into base64.  The base 64 produced string will be placed
  *  into the output param.  Consumers of this function are responsible for
@@ -123,6 +164,19 @@ char *b64_encode_with_alloc(const uint8_t *raw, size_t len, size_t *out_len);
 size_t b64url_get_encoded_buffer_size(const size_t decoded_size);
 
 
+/**
+ * The same as b64_get_encoded_buffer_size_checked() but for b64url_encode().
+ *
+ * @param decoded_size size of the decoded data
+ * @param overflow     if not NULL, set to 1 if the size doesn't fit, or 0
+ *                     otherwise
+ *
+ * @return size of the buffer required to hold the encoded data, or 0 if it
+ *         doesn't fit
+ */
+size_t b64url_get_encoded_buffer_size_checked(const size_t decoded_size, int *overflow);
+
+
 /**
  * Get the size of the buffer needed to hold the output decoded from
  * base64url encoded data.
@@ -136,6 +190,19 @@ size_t b64url_get_encoded_buffer_size(const size_t decoded_size);
 size_t b64url_get_decoded_buffer_size(const size_t encoded_size);
 
 
+/**
+ * The same as b64_get_decoded_size() but for b64url_decode().
+ *
+ * @param enc          pointer to the base64url encoded data
+ * @param len          length of the encoded data
+ * @param needs_decode if not NULL, set to 1 if the size alone doesn't prove the
+ *                     input is valid, or 0 otherwise
+ *
+ * @return the exact size of the raw data, or 0 if the input is invalid
+ */
+size_t b64url_get_decoded_size(const uint8_t *enc, size_t len, int *needs_decode);
+
+
 /**
  *  Encodes the input into base64url.  The base 64 produced string will be placed
  *  into the output param.  Consumers of this function are responsible for
@@ -202,6 +269,344 @@ uint8_t *b64url_decode_with_alloc(const uint8_t *enc, size_t len, size_t *out_le
 char *b64url_encode_with_alloc(const uint8_t *raw, size_t len, size_t *out_len);
 
 
+/*----------------------------------------------------------------------------*/
+/*                                UTF-16 Text                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ *  Encodes the input into standard base64 written as UTF-16 code units, for
+ *  handing directly to Java or JavaScript strings.  The sizes are the same as
+ *  for b64_encode(), counted in code units instead of bytes.
+ *
+ *  @note: The output buffer must hold b64_get_encoded_buffer_size(len) units.
+ *
+ *  @param raw  pointer to the raw data
+ *  @param len  size of the raw data in bytes
+ *  @param out  pointer to where the encoded code units should be placed
+ */
+void b64_encode_utf16(const uint8_t *raw, const size_t len, uint16_t *out);
+
+
+/**
+ * Decodes standard base64 held as UTF-16 code units.  Any code unit above
+ * 0x7F is rejected as part of the decode.
+ *
+ * @note: The output buffer must hold b64_get_decoded_buffer_size(len) bytes.
+ *
+ * @param enc  pointer to the encoded code units
+ * @param len  number of encoded code units
+ * @param out  pointer to where the decoded data should be placed
+ *
+ * @return total number of bytes in the decoded array, or 0 if there was a
+ *         decoding error
+ */
+size_t b64_decode_utf16(const uint16_t *enc, const size_t len, uint8_t *out);
+
+
+/**
+ *  Encodes the input into base64url written as UTF-16 code units.
+ *
+ *  @note: The output buffer must hold b64url_get_encoded_buffer_size(len)
+ *         units.
+ *
+ *  @param raw  pointer to the raw data
+ *  @param len  size of the raw data in bytes
+ *  @param out  pointer to where the encoded code units should be placed
+ */
+void b64url_encode_utf16(const uint8_t *raw, const size_t len, uint16_t *out);
+
+
+/**
+ * Decodes base64url held as UTF-16 code units.  Any code unit above 0x7F is
+ * rejected as part of the decode.
+ *
+ * @note: The output buffer must hold b64url_get_decoded_buffer_size(len)
+ *        bytes.
+ *
+ * @param enc  pointer to the encoded code units
+ * @param len  number of encoded code units
+ * @param out  pointer to where the decoded data should be placed
+ *
+ * @return total number of bytes in the decoded array, or 0 if there was a
+ *         decoding error
+ */
+size_t b64url_decode_utf16(const uint16_t *enc, const size_t len, uint8_t *out);
+
+
+/*----------------------------------------------------------------------------*/
+/*                             Flexible Decoding                              */
+/*----------------------------------------------------------------------------*/
+
+/* Alphabet flags, choose one. */
+#define B64_DECODE_STANDARD     0x0000 /* '+' and '/' */
+#define B64_DECODE_URL          0x0001 /* '-' and '_' */
+#define B64_DECODE_ANY_ALPHABET 0x0002 /* either pair, even mixed in one input */
+
+/* Padding flags, choose one. */
+#define B64_DECODE_PAD_OPTIONAL  0x0000 /* accept padded or unpadded input */
+#define B64_DECODE_PAD_REQUIRED  0x0010 /* the length must be a multiple of 4 */
+#define B64_DECODE_PAD_FORBIDDEN 0x0020 /* reject any '=' padding */
+
+/* Mode flags, optional.
+ *
+ * B64_DECODE_CONSTANT_TIME is for keys and other secrets.  The characters are
+ * translated with arithmetic instead of a table, and an invalid one doesn't
+ * end the decode early.  The time taken and the memory touched then depend
+ * only on the length, padding and flags, never on the secret bytes.  It costs
+ * several times the throughput of the default decode (see the
+ * b64_decode_ct path of the benchmark), so only use it where it is needed.
+ * On error the output buffer is zeroed rather than left partially written. */
+#define B64_DECODE_CONSTANT_TIME 0x0100
+
+
+/**
+ * Get the size of the buffer needed to hold the output of b64_decode_flags().
+ *
+ * @note: The size MAY be larger the the resulting decoded output.
+ *
+ * @param encoded_size size of the encoded data
+ * @param flags        the B64_DECODE_* flags that will be used to decode
+ *
+ * @return size of the raw data, or 0 if no input of this length is valid
+ */
+size_t b64_get_decoded_buffer_size_flags(const size_t encoded_size, unsigned flags);
+
+
+/**
+ * The same as b64_get_decoded_size() but for b64_decode_flags().
+ *
+ * @param enc          pointer to the encoded data
+ * @param len          length of the encoded data
+ * @param flags        the B64_DECODE_* flags that will be used to decode
+ * @param needs_decode if not NULL, set to 1 if the size alone doesn't prove the
+ *                     input is valid, or 0 otherwise
+ *
+ * @return the exact size of the raw data, or 0 if the input is invalid
+ */
+size_t b64_get_decoded_size_flags(const uint8_t *enc, size_t len, unsigned flags,
+                                  int *needs_decode);
+
+
+/**
+ * Decodes the buffer using the alphabet and padding rules selected by the
+ * flags, in a single pass.  This replaces trying b64_decode() and then
+ * b64url_decode(), or re-padding the input first.
+ *
+ * b64_decode() is equivalent to B64_DECODE_STANDARD | B64_DECODE_PAD_REQUIRED
+ * and b64url_decode() is equivalent to B64_DECODE_URL | B64_DECODE_PAD_OPTIONAL.
+ *
+ * @note: The output buffer must be large enough to handle the decoded payload.
+ *
+ * @param enc    pointer to the encoded data
+ * @param len    size of the encoded data
+ * @param out    pointer to where the decoded data should be placed
+ * @param flags  a bitwise OR of one alphabet and one padding flag, plus any
+ *               mode flags
+ *
+ * @return total number of bytes in the decoded array, or 0 if there was a
+ *         decoding error
+ */
+size_t b64_decode_flags(const uint8_t *enc, const size_t len, uint8_t *out, unsigned flags);
+
+
+/**
+ * Decodes the buffer using b64_decode_flags() into a new buffer with the size
+ * specified in out_len.
+ *
+ * @note: The returned buffer must have free() called to prevent a memory
+ *        leak.
+ *
+ * @param enc      pointer to the encoded data
+ * @param len      size of the encoded data
+ * @param out_len  pointer to where the resulting buffer length is placed
+ * @param flags    a bitwise OR of one alphabet and one padding flag, plus any
+ *                 mode flags
+ *
+ * @return the buffer containing the raw bytes or NULL on error
+ */
+uint8_t *b64_decode_flags_with_alloc(const uint8_t *enc, size_t len, size_t *out_len,
+                                     unsigned flags);
+
+
+/*----------------------------------------------------------------------------*/
+/*                            JSON Escaped Base64                             */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Decodes standard base64 text taken verbatim from inside a JSON string, so
+ * it may still contain the escapes JSON allows for the base64 characters:
+ * "\/" and "\uXXXX" (for example "\u002B" or "\u003D").  The escapes are
+ * resolved during the decode itself, without an intermediate buffer.  Text
+ * without any escapes is decoded exactly like b64_decode().
+ *
+ * @note: The output buffer must be large enough to handle the decoded payload,
+ *        (len / 4) * 3 bytes is always sufficient.
+ *
+ * @param enc  pointer to the escaped encoded data
+ * @param len  size of the escaped encoded data
+ * @param out  pointer to where the decoded data should be placed
+ *
+ * @return total number of bytes in the decoded array, or 0 if there was a
+ *         decoding or escaping error
+ */
+size_t b64_decode_json(const uint8_t *enc, const size_t len, uint8_t *out);
+
+
+/**
+ * Decodes base64url text taken verbatim from inside a JSON string.  See
+ * b64_decode_json() for the escapes handled.
+ *
+ * @note: The output buffer must be large enough to handle the decoded payload,
+ *        (len / 4) * 3 + 2 bytes is always sufficient.
+ *
+ * @param enc  pointer to the escaped encoded data
+ * @param len  size of the escaped encoded data
+ * @param out  pointer to where the decoded data should be placed
+ *
+ * @return total number of bytes in the decoded array, or 0 if there was a
+ *         decoding or escaping error
+ */
+size_t b64url_decode_json(const uint8_t *enc, const size_t len, uint8_t *out);
+
+
+/*----------------------------------------------------------------------------*/
+/*                              Buffer Building                               */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * A growable output buffer that the *_append() functions encode or decode
+ * directly into.  Zero initialize it to start with an empty buffer.
+ *
+ * @note: The caller owns data and must release it with the allocator that
+ *        matches realloc_fn (free() by default).
+ */
+typedef struct {
+    uint8_t *data; /* the buffer contents */
+    size_t len;    /* the number of bytes used */
+    size_t size;   /* the number of bytes allocated */
+
+    /* The allocator used to grow data, or NULL to use realloc(). */
+    void *(*realloc_fn)(void *ptr, size_t size);
+} b64_buf_t;
+
+
+/**
+ * Encodes the raw bytes using standard base64 directly onto the end of the
+ * buffer.  Exactly b64_get_encoded_buffer_size(len) bytes are reserved, with
+ * the allocation growing geometrically when more room is needed.
+ *
+ * @note: The buffer is not '\0' terminated.
+ *
+ * @param dst  pointer to the buffer to append to
+ * @param raw  pointer to the raw data
+ * @param len  size of the raw data in bytes
+ *
+ * @return number of bytes appended, or 0 if there was an error (the buffer
+ *         contents are left unchanged)
+ */
+size_t b64_encode_append(b64_buf_t *dst, const uint8_t *raw, size_t len);
+
+
+/**
+ * Decodes the standard base64 buffer directly onto the end of the buffer.
+ *
+ * @param dst  pointer to the buffer to append to
+ * @param enc  pointer to the encoded data
+ * @param len  size of the encoded data
+ *
+ * @return number of bytes appended, or 0 if there was a decoding error (the
+ *         buffer contents are left unchanged)
+ */
+size_t b64_decode_append(b64_buf_t *dst, const uint8_t *enc, size_t len);
+
+
+/**
+ * Encodes the raw bytes using base64url directly onto the end of the buffer.
+ *
+ * @note: The buffer is not '\0' terminated.
+ *
+ * @param dst  pointer to the buffer to append to
+ * @param raw  pointer to the raw data
+ * @param len  size of the raw data in bytes
+ *
+ * @return number of bytes appended, or 0 if there was an error (the buffer
+ *         contents are left unchanged)
+ */
+size_t b64url_encode_append(b64_buf_t *dst, const uint8_t *raw, size_t len);
+
+
+/**
+ * Decodes the base64url buffer directly onto the end of the buffer.
+ *
+ * @param dst  pointer to the buffer to append to
+ * @param enc  pointer to the encoded data
+ * @param len  size of the encoded data
+ *
+ * @return number of bytes appended, or 0 if there was a decoding error (the
+ *         buffer contents are left unchanged)
+ */
+size_t b64url_decode_append(b64_buf_t *dst, const uint8_t *enc, size_t len);
+
+
+/*----------------------------------------------------------------------------*/
+/*                              Chunked Decoding                              */
+/*----------------------------------------------------------------------------*/
+
+/* The most bytes passed to a b64_chunk_cb_t at a time.  The chunk and the
+ * text it came from fit in a typical 32 KiB L1 data cache with room to spare
+ * for the consumer. */
+#define B64_DECODE_CHUNK_MAX 6144
+
+
+/**
+ * Consumes one chunk of decoded bytes.
+ *
+ * @note: The bytes are only valid until the callback returns.
+ *
+ * @param raw   pointer to the decoded bytes
+ * @param len   the number of decoded bytes, 1 to B64_DECODE_CHUNK_MAX
+ * @param user  the pointer passed to b64_decode_chunked()
+ *
+ * @return 0 to continue, or anything else to stop the decode
+ */
+typedef int (*b64_chunk_cb_t)(const uint8_t *raw, size_t len, void *user);
+
+
+/**
+ * Decodes the buffer a chunk at a time into a small buffer on the stack and
+ * passes each chunk to the callback while it is still in the cache.  This is
+ * for output that is parsed (protobuf, CBOR, ...) right after decoding: the
+ * parser reads bytes that were just written instead of a full sized buffer
+ * that has since been evicted, and no output buffer is allocated at all.
+ *
+ * The input is held to the same rules as b64_decode_flags() with the same
+ * flags, and the chunks put together are the same bytes.
+ *
+ * @note: The chunks are passed on as they are decoded, so when the input turns
+ *        out to be invalid further in, the earlier chunks have already been
+ *        consumed.  An invalid length is rejected before any chunk.
+ *
+ * @note: With B64_DECODE_CONSTANT_TIME an invalid chunk does not end the
+ *        decode early: the rest of the input is still decoded, but passed to
+ *        no more callbacks, so the time taken does not depend on where the
+ *        bad character is.  Which chunks reached the callback still does, so
+ *        a callback whose own time matters should buffer the chunks until
+ *        the decode returns.
+ *
+ * @param enc    pointer to the encoded data
+ * @param len    size of the encoded data
+ * @param flags  a bitwise OR of one alphabet and one padding flag, plus any
+ *               mode flags
+ * @param cb     the callback to pass each chunk to, in order
+ * @param user   passed to every call of cb
+ *
+ * @return total number of bytes decoded, or 0 if there was a decoding error
+ *         or the callback stopped the decode
+ */
+size_t b64_decode_chunked(const uint8_t *enc, size_t len, unsigned flags, b64_chunk_cb_t cb,
+                          void *user);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,478 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+#ifndef __BASE64_LIB_HPP__
+#define __BASE64_LIB_HPP__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#if defined(__has_include)
+#if __has_include(<version>)
+#include <version>
+#endif
+#endif
+
+#if defined(__cpp_lib_span)
+#include <span>
+#endif
+
+#if defined(__cpp_lib_is_constant_evaluated)
+#include <type_traits>
+#endif
+
+#include "base64.h"
+
+namespace trower {
+namespace base64 {
+
+/*----------------------------------------------------------------------------*/
+/*                                 Alphabets                                  */
+/*----------------------------------------------------------------------------*/
+
+enum class alphabet {
+    standard, /* RFC 4648 section 4, padded with '=' */
+    url,      /* RFC 4648 section 5, unpadded */
+};
+
+template <alphabet A>
+struct alphabet_traits;
+
+template <>
+struct alphabet_traits<alphabet::standard> {
+    static constexpr char map[]  = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/=";
+    static constexpr bool padded = true;
+
+    static void encode(const std::uint8_t *raw, std::size_t len, std::uint8_t *out) noexcept
+    {
+        b64_encode(raw, len, out);
+    }
+
+    static std::size_t decode(const std::uint8_t *enc, std::size_t len, std::uint8_t *out) noexcept
+    {
+        return b64_decode(enc, len, out);
+    }
+};
+
+template <>
+struct alphabet_traits<alphabet::url> {
+    static constexpr char map[]  = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    static constexpr bool padded = false;
+
+    static void encode(const std::uint8_t *raw, std::size_t len, std::uint8_t *out) noexcept
+    {
+        b64url_encode(raw, len, out);
+    }
+
+    static std::size_t decode(const std::uint8_t *enc, std::size_t len, std::uint8_t *out) noexcept
+    {
+        return b64url_decode(enc, len, out);
+    }
+};
+
+
+/*----------------------------------------------------------------------------*/
+/*                                   Sizing                                   */
+/*----------------------------------------------------------------------------*/
+
+/**
+ *  Compile time equivalent of b64_get_encoded_buffer_size() and
+ *  b64url_get_encoded_buffer_size().
+ *
+ *  @note: The size returned does not account for any trailing '\0'.
+ */
+template <alphabet A = alphabet::standard>
+constexpr std::size_t encoded_size(std::size_t decoded_size) noexcept
+{
+    if (alphabet_traits<A>::padded) {
+        return ((decoded_size + 2) / 3) * 4;
+    }
+
+    std::size_t remainder = decoded_size % 3;
+    return (decoded_size / 3) * 4 + (remainder ? remainder + 1 : 0);
+}
+
+
+/**
+ *  Compile time equivalent of b64_get_decoded_buffer_size() and
+ *  b64url_get_decoded_buffer_size().
+ *
+ *  @note: The size MAY be larger the the resulting decoded output.
+ *
+ *  @return the size of the raw data or 0 if the length is not valid
+ */
+template <alphabet A = alphabet::standard>
+constexpr std::size_t decoded_size(std::size_t encoded_size) noexcept
+{
+    std::size_t rv = (encoded_size / 4) * 3;
+
+    if (!alphabet_traits<A>::padded && (0x03 & encoded_size)) {
+        rv += (0x03 & encoded_size) - 1;
+    }
+
+    if (base64::encoded_size<A>(rv) != encoded_size) {
+        rv = 0;
+    }
+
+    return rv;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                         Compile Time Capable Codec                         */
+/*----------------------------------------------------------------------------*/
+
+namespace detail {
+
+/* -1 = invalid, -2 = padding */
+template <alphabet A>
+struct decode_table {
+    std::int8_t map[256] = {};
+
+    constexpr decode_table() noexcept
+    {
+        for (int i = 0; i < 256; i++) {
+            map[i] = -1;
+        }
+        for (int i = 0; i < 64; i++) {
+            map[static_cast<unsigned char>(alphabet_traits<A>::map[i])] = static_cast<std::int8_t>(i);
+        }
+        map[static_cast<unsigned char>('=')] = -2;
+    }
+};
+
+template <alphabet A>
+inline constexpr decode_table<A> decode_map{};
+
+template <alphabet A>
+constexpr std::size_t encode(const std::uint8_t *in, std::size_t len, char *out) noexcept
+{
+    const char *map = alphabet_traits<A>::map;
+    std::size_t j   = 0;
+    std::size_t i   = 0;
+
+    for (; i + 3 <= len; i += 3) {
+        std::uint32_t bits = (std::uint32_t(in[i]) << 16) | (std::uint32_t(in[i + 1]) << 8) | in[i + 2];
+
+        out[j++] = map[0x3f & (bits >> 18)];
+        out[j++] = map[0x3f & (bits >> 12)];
+        out[j++] = map[0x3f & (bits >> 6)];
+        out[j++] = map[0x3f & bits];
+    }
+
+    if (i < len) {
+        std::uint32_t bits = std::uint32_t(in[i]) << 16;
+
+        if (i + 1 < len) {
+            bits |= std::uint32_t(in[i + 1]) << 8;
+        }
+
+        out[j++] = map[0x3f & (bits >> 18)];
+        out[j++] = map[0x3f & (bits >> 12)];
+        if (i + 1 < len) {
+            out[j++] = map[0x3f & (bits >> 6)];
+        }
+    }
+
+    while (alphabet_traits<A>::padded && (0x03 & j)) {
+        out[j++] = map[64];
+    }
+
+    return j;
+}
+
+template <alphabet A>
+constexpr std::size_t decode(const char *in, std::size_t len, std::uint8_t *out) noexcept
+{
+    const std::int8_t *map = decode_map<A>.map;
+    std::uint32_t bits     = 0;
+    int bit_count          = 0;
+    std::size_t j          = 0;
+
+    if (!in || !out || 0 == base64::decoded_size<A>(len)) {
+        return 0;
+    }
+
+    /* The same rule as the C decode: padding only ever completes a group of
+     * 4, for either alphabet. */
+    if ('=' == in[len - 1]) {
+        if (0 != (0x03 & len)) {
+            return 0;
+        }
+        len--;
+        if ('=' == in[len - 1]) {
+            len--;
+        }
+    }
+
+    for (std::size_t i = 0; i < len; i++) {
+        std::int8_t val = map[static_cast<unsigned char>(in[i])];
+
+        if (val < 0) {
+            return 0;
+        }
+        bits = (bits << 6) | static_cast<std::uint32_t>(val);
+        bit_count += 6;
+
+        if (8 <= bit_count) {
+            bit_count -= 8;
+            out[j++] = static_cast<std::uint8_t>(0x0ff & (bits >> bit_count));
+        }
+    }
+
+    return j;
+}
+
+} /* namespace detail */
+
+
+/**
+ *  Encodes the raw bytes into the output buffer.  Usable in constant
+ *  expressions; at run time under C++20 this uses the C library codec.
+ *
+ *  @note: The output buffer must hold at least encoded_size<A>(len) chars.
+ *
+ *  @return the number of characters written
+ */
+template <alphabet A = alphabet::standard>
+constexpr std::size_t encode_to(const std::uint8_t *raw, std::size_t len, char *out) noexcept
+{
+#if defined(__cpp_lib_is_constant_evaluated)
+    if (!std::is_constant_evaluated()) {
+        alphabet_traits<A>::encode(raw, len, reinterpret_cast<std::uint8_t *>(out));
+        return encoded_size<A>(len);
+    }
+#endif
+    return detail::encode<A>(raw, len, out);
+}
+
+
+/**
+ *  Decodes the characters into the output buffer.  Usable in constant
+ *  expressions; at run time under C++20 this uses the C library codec.
+ *
+ *  @note: The output buffer must hold at least decoded_size<A>(len) bytes.
+ *
+ *  @return the number of bytes written, or 0 if there was a decoding error
+ */
+template <alphabet A = alphabet::standard>
+constexpr std::size_t decode_to(const char *enc, std::size_t len, std::uint8_t *out) noexcept
+{
+#if defined(__cpp_lib_is_constant_evaluated)
+    if (!std::is_constant_evaluated()) {
+        return alphabet_traits<A>::decode(reinterpret_cast<const std::uint8_t *>(enc), len, out);
+    }
+#endif
+    return detail::decode<A>(enc, len, out);
+}
+
+
+/**
+ *  The result of decode_literal(): a fixed capacity buffer and the number of
+ *  bytes that were decoded into it.  A size of 0 denotes a decoding error.
+ */
+template <std::size_t N>
+struct decoded_literal {
+    std::array<std::uint8_t, N> data{};
+    std::size_t size = 0;
+
+    constexpr const std::uint8_t *begin() const noexcept { return data.data(); }
+    constexpr const std::uint8_t *end() const noexcept { return data.data() + size; }
+};
+
+
+/**
+ *  Encodes a string literal (without its trailing '\0') at compile time.
+ *
+ *  @return a '\0' terminated array holding the encoded text
+ */
+template <alphabet A = alphabet::standard, std::size_t N>
+constexpr std::array<char, encoded_size<A>(N - 1) + 1> encode_literal(const char (&lit)[N]) noexcept
+{
+    std::array<std::uint8_t, N> raw{};
+    std::array<char, encoded_size<A>(N - 1) + 1> rv{};
+
+    for (std::size_t i = 0; i < N; i++) {
+        raw[i] = static_cast<std::uint8_t>(lit[i]);
+    }
+    detail::encode<A>(raw.data(), N - 1, rv.data());
+
+    return rv;
+}
+
+
+/**
+ *  Decodes an encoded string literal (without its trailing '\0') at compile
+ *  time, for example to embed keys in a binary.
+ */
+template <alphabet A = alphabet::standard, std::size_t N>
+constexpr decoded_literal<(N - 1) / 4 * 3 + 2> decode_literal(const char (&lit)[N]) noexcept
+{
+    decoded_literal<(N - 1) / 4 * 3 + 2> rv{};
+
+    rv.size = detail::decode<A>(lit, N - 1, rv.data.data());
+
+    return rv;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                               Run Time Codec                               */
+/*----------------------------------------------------------------------------*/
+
+namespace detail {
+
+/* Grows the string by n characters without zero filling them first when the
+ * standard library allows it, then lets fn() write them.  fn() returns the
+ * number of characters it actually produced. */
+template <typename Fn>
+void append_uninitialized(std::string &s, std::size_t n, Fn fn)
+{
+    std::size_t base = s.size();
+
+    if (s.max_size() - base < n) {
+        throw std::length_error("trower::base64: output too long for a string");
+    }
+
+#if defined(__cpp_lib_string_resize_and_overwrite)
+    s.resize_and_overwrite(base + n, [&](char *p, std::size_t) {
+        return base + fn(p + base);
+    });
+#else
+    s.resize(base + n);
+    s.resize(base + fn(&s[base]));
+#endif
+}
+
+} /* namespace detail */
+
+
+/**
+ *  Encodes the raw bytes into caller provided storage.
+ *
+ *  @return the number of characters written, or 0 if out_len is too small
+ */
+template <alphabet A = alphabet::standard>
+std::size_t encode(const std::uint8_t *raw, std::size_t len, char *out, std::size_t out_len) noexcept
+{
+    std::size_t need = encoded_size<A>(len);
+
+    if (!raw || !out || (B64_MAX_ENCODE_LEN < len) || out_len < need) {
+        return 0;
+    }
+    alphabet_traits<A>::encode(raw, len, reinterpret_cast<std::uint8_t *>(out));
+
+    return need;
+}
+
+
+/**
+ *  Appends the encoded form of the raw bytes to the string.
+ *
+ *  @note: Throws std::length_error if the result doesn't fit in a string.
+ */
+template <alphabet A = alphabet::standard>
+void encode_append(std::string &dst, std::string_view raw)
+{
+    std::size_t need = encoded_size<A>(raw.size());
+
+    if (B64_MAX_ENCODE_LEN < raw.size()) {
+        throw std::length_error("trower::base64: output too long for a string");
+    }
+    if (0 == need) {
+        return;
+    }
+    detail::append_uninitialized(dst, need, [&](char *p) {
+        alphabet_traits<A>::encode(reinterpret_cast<const std::uint8_t *>(raw.data()),
+                                   raw.size(), reinterpret_cast<std::uint8_t *>(p));
+        return need;
+    });
+}
+
+
+/**
+ *  Encodes the raw bytes into a new string.
+ */
+template <alphabet A = alphabet::standard>
+std::string encode(std::string_view raw)
+{
+    std::string rv;
+
+    encode_append<A>(rv, raw);
+
+    return rv;
+}
+
+
+/**
+ *  Decodes the characters into caller provided storage.
+ *
+ *  @return the number of bytes written, or 0 if there was a decoding error or
+ *          out_len is too small
+ */
+template <alphabet A = alphabet::standard>
+std::size_t decode(std::string_view enc, std::uint8_t *out, std::size_t out_len) noexcept
+{
+    std::size_t need = decoded_size<A>(enc.size());
+
+    if (!out || 0 == need || out_len < need) {
+        return 0;
+    }
+
+    return alphabet_traits<A>::decode(reinterpret_cast<const std::uint8_t *>(enc.data()),
+                                      enc.size(), out);
+}
+
+
+/**
+ *  Decodes the characters, appending the raw bytes to the string.
+ *
+ *  @return true on success, false if there was a decoding error (dst is left
+ *          unchanged)
+ */
+template <alphabet A = alphabet::standard>
+bool decode_append(std::string &dst, std::string_view enc)
+{
+    std::size_t need = decoded_size<A>(enc.size());
+    std::size_t base = dst.size();
+    std::size_t got  = 0;
+
+    if (0 == need) {
+        return false;
+    }
+    detail::append_uninitialized(dst, need, [&](char *p) {
+        got = alphabet_traits<A>::decode(reinterpret_cast<const std::uint8_t *>(enc.data()),
+                                         enc.size(), reinterpret_cast<std::uint8_t *>(p));
+        return got;
+    });
+    if (0 == got) {
+        dst.resize(base);
+    }
+
+    return 0 != got;
+}
+
+
+#if defined(__cpp_lib_span)
+
+template <alphabet A = alphabet::standard>
+std::size_t encode(std::span<const std::uint8_t> raw, std::span<char> out) noexcept
+{
+    return encode<A>(raw.data(), raw.size(), out.data(), out.size());
+}
+
+template <alphabet A = alphabet::standard>
+std::size_t decode(std::string_view enc, std::span<std::uint8_t> out) noexcept
+{
+    return decode<A>(enc, out.data(), out.size());
+}
+
+#endif
+
+} /* namespace base64 */
+} /* namespace trower */
+
+#endif /* __BASE64_LIB_HPP__ */
@@ -0,0 +1,105 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+#ifndef __BASE64_CACHE__
+#define __BASE64_CACHE__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*----------------------------------------------------------------------------*/
+/*                                Encode Cache                                */
+/*----------------------------------------------------------------------------*/
+
+/* A fixed size cache of encoded values, for programs that encode the same
+ * small inputs (MAC addresses, account ids, static keys) over and over.
+ *
+ * Lookups take no locks and a hit writes nothing shared (each thread counts
+ * its hits in counters of its own), so any number of threads may look up the
+ * same values at once.  Entries are never evicted: once the cache holds its
+ * capacity, lookups of new inputs return NULL and the caller falls back to
+ * b64_encode().  This is what lets every returned pointer stay valid, without
+ * reference counting, until b64_cache_destroy().
+ *
+ * The cache only helps where nearly every lookup hits.  For MAC sized (6
+ * byte) keys a hit costs about 0.7 times as much as b64_encode(), while a
+ * miss, which hashes, probes and then encodes anyway, costs about 3 times as
+ * much.  The saving grows with the key length, but a value that is seen only
+ * once or twice is cheaper to encode directly. */
+
+typedef struct b64_cache b64_cache_t;
+
+typedef struct {
+    uint64_t hits;     /* lookups answered from the cache */
+    uint64_t misses;   /* lookups that had to encode */
+    uint64_t rejected; /* misses that could not be added to the cache */
+    size_t entries;    /* the number of cached values */
+    size_t capacity;   /* the most values the cache will hold */
+} b64_cache_stats_t;
+
+
+/**
+ * Creates an encode cache.
+ *
+ * @param capacity  the most values the cache will hold (must be > 0)
+ * @param max_len   the longest raw input that will be cached (must be > 0)
+ *
+ * @return the cache, or NULL on error
+ */
+b64_cache_t *b64_cache_create(size_t capacity, size_t max_len);
+
+
+/**
+ * Frees the cache and every value it returned.  No other thread may be using
+ * the cache.
+ *
+ * @param cache  the cache to free (NULL is ignored)
+ */
+void b64_cache_destroy(b64_cache_t *cache);
+
+
+/**
+ * Returns the base64 encoding of the raw bytes, encoding and caching them
+ * the first time they are seen.
+ *
+ * @note: The returned string is '\0' terminated and owned by the cache.  It
+ *        stays valid and unchanged until b64_cache_destroy().
+ *
+ * @param cache    the cache to use
+ * @param raw      the raw bytes to encode
+ * @param len      the number of raw bytes (must be > 0 and <= max_len)
+ * @param out_len  if not NULL, the length of the encoded string
+ *
+ * @return the encoded string, or NULL if the input is invalid, too long or
+ *         the cache is full (the caller should then use b64_encode())
+ */
+const char *b64_cache_encode(b64_cache_t *cache, const uint8_t *raw, size_t len,
+                             size_t *out_len);
+
+
+/**
+ * The same as b64_cache_encode() but using b64url_encode().  Values are
+ * cached separately for each alphabet in the same cache.
+ */
+const char *b64url_cache_encode(b64_cache_t *cache, const uint8_t *raw, size_t len,
+                                size_t *out_len);
+
+
+/**
+ * Reads the counters of a cache.  The counters are updated without locks,
+ * so lookups in flight on other threads may or may not be included.
+ *
+ * @param cache  the cache
+ * @param out    pointer to where the counters should be placed
+ */
+void b64_cache_get_stats(const b64_cache_t *cache, b64_cache_stats_t *out);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BASE64_CACHE__ */
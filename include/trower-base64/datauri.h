@@ -0,0 +1,112 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+#ifndef __BASE64_DATAURI__
+#define __BASE64_DATAURI__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*----------------------------------------------------------------------------*/
+/*                                 data: URIs                                 */
+/*----------------------------------------------------------------------------*/
+
+/* A parsed "data:[<media type>];base64,<payload>" URI (RFC 2397).  Both
+ * parts point into the URI that was parsed; nothing is copied. */
+typedef struct {
+    const char *mime; /* the media type and its parameters, or NULL */
+    size_t mime_len;  /* 0 if the URI has no media type, which means
+                       * "text/plain;charset=US-ASCII" */
+    const char *payload;
+    size_t payload_len;
+} b64_data_uri_t;
+
+
+/**
+ * Parses the header of a base64 data: URI in place.
+ *
+ * The "data:" scheme and ";base64" are matched without regard to case.  URIs
+ * that aren't base64 encoded, or have an empty payload, are rejected.
+ *
+ * @param uri  pointer to the URI
+ * @param len  length of the URI
+ * @param out  where the media type and payload views are placed
+ *
+ * @return the exact number of bytes b64_data_uri_decode() will write, or 0 if
+ *         the URI is invalid
+ */
+size_t b64_data_uri_parse(const char *uri, size_t len, b64_data_uri_t *out);
+
+
+/**
+ * Decodes the payload of a parsed URI.  The payload is standard base64 with
+ * optional padding.
+ *
+ * @note: The output buffer must hold the size returned by
+ *        b64_data_uri_parse().  It may be the payload itself, i.e.
+ *        (uint8_t *) uri->payload, to decode in place when the caller owns the
+ *        URI's memory; the payload is overwritten.
+ *
+ * @param uri  the parsed URI
+ * @param out  the output buffer
+ *
+ * @return the number of decoded bytes, or 0 if the payload is invalid
+ */
+size_t b64_data_uri_decode(const b64_data_uri_t *uri, uint8_t *out);
+
+
+/**
+ * Get the exact size of the URI that b64_data_uri_encode() will write.
+ *
+ * @param mime_len  length of the media type (0 for none)
+ * @param len       number of raw bytes
+ *
+ * @return the URI length in bytes, or 0 if it can't be represented
+ */
+size_t b64_data_uri_get_encoded_size(size_t mime_len, size_t len);
+
+
+/**
+ * Writes "data:<mime>;base64,<encoded raw bytes>".
+ *
+ * @note: The output buffer must hold b64_data_uri_get_encoded_size(mime_len,
+ *        len) bytes.  It is not '\0' terminated.
+ *
+ * @param mime      the media type, which may not contain a ','
+ * @param mime_len  length of the media type (0 for none)
+ * @param raw       the raw bytes
+ * @param len       number of raw bytes
+ * @param out       the output buffer
+ *
+ * @return the number of bytes written, or 0 on error
+ */
+size_t b64_data_uri_encode(const char *mime, size_t mime_len, const uint8_t *raw, size_t len,
+                           char *out);
+
+
+/**
+ * The same as b64_data_uri_encode() but the '\0' terminated URI is written to
+ * a buffer allocated to exactly fit it.
+ *
+ * @note: The caller is responsible for freeing the returned buffer.
+ *
+ * @param mime      the media type, which may not contain a ','
+ * @param mime_len  length of the media type (0 for none)
+ * @param raw       the raw bytes
+ * @param len       number of raw bytes
+ * @param out_len   if not NULL, the length of the URI (without the '\0')
+ *
+ * @return the URI, or NULL on error
+ */
+char *b64_data_uri_encode_with_alloc(const char *mime, size_t mime_len, const uint8_t *raw,
+                                     size_t len, size_t *out_len);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BASE64_DATAURI__ */
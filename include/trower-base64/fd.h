@@ -0,0 +1,69 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+#ifndef __BASE64_FD__
+#define __BASE64_FD__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*                            File Descriptor Streams                         */
+/*----------------------------------------------------------------------------*/
+
+/* Encoding flags, choose one. */
+#define B64_ENCODE_STANDARD 0x0000 /* '+' and '/', padded like b64_encode() */
+#define B64_ENCODE_URL      0x0001 /* '-' and '_', unpadded like b64url_encode() */
+
+
+/**
+ * Encodes everything that can be read from in_fd and writes it to out_fd,
+ * until in_fd reaches end of file.  The output is the same as encoding all of
+ * the input in one call.
+ *
+ * Regular files are read a large block at a time on the calling thread.  For
+ * pipes and sockets a reader thread fills one of two blocks while the other
+ * is encoded, so waiting for input overlaps the encoding.  Output is gathered
+ * and written 64 KiB or more at a time.  The page aligned buffers are
+ * allocated on a thread's first call (about 640 KiB) and kept until the
+ * thread exits.
+ *
+ * @note: Writing to a socket or pipe whose reader has gone away raises
+ *        SIGPIPE unless the caller ignores it.
+ *
+ * @param in_fd   the descriptor to read raw bytes from (file, pipe, socket)
+ * @param out_fd  the descriptor to write the encoded text to
+ * @param flags   one of the B64_ENCODE_* flags
+ *
+ * @return 0 on success, or -1 with errno set if reading, writing or starting
+ *         the reader failed
+ */
+int b64_encode_fd(int in_fd, int out_fd, unsigned flags);
+
+
+/**
+ * Decodes everything that can be read from in_fd and writes the raw bytes
+ * to out_fd, until in_fd reaches end of file.  The input is held to the same
+ * rules as passing all of it to b64_decode_flags() with the same flags, except
+ * that empty input is allowed and writes nothing, and that CR and LF are
+ * skipped wherever they appear, so line wrapped text (MIME, base64 -w) decodes
+ * as is.  Other whitespace is still invalid.
+ *
+ * @note: Blocks are written as they are decoded, so when the input turns out
+ *        to be invalid, the output up to that point has already been written.
+ *
+ * @param in_fd   the descriptor to read the encoded text from
+ * @param out_fd  the descriptor to write the raw bytes to
+ * @param flags   the B64_DECODE_* flags from base64.h
+ *
+ * @return 0 on success, or -1 with errno set; errno is EINVAL if the input is
+ *         not valid base64
+ */
+int b64_decode_fd(int in_fd, int out_fd, unsigned flags);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BASE64_FD__ */
@@ -0,0 +1,68 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+#ifndef __BASE64_PEM__
+#define __BASE64_PEM__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*----------------------------------------------------------------------------*/
+/*                                 PEM Bundles                                */
+/*----------------------------------------------------------------------------*/
+
+/* One decoded "-----BEGIN <label>-----" ... "-----END <label>-----" block. */
+typedef struct {
+    const char *label;  /* e.g. "CERTIFICATE", '\0' terminated */
+    const uint8_t *der; /* the decoded body */
+    size_t der_len;     /* the number of bytes in der */
+} b64_pem_entry_t;
+
+/* The blocks of a bundle.  Every label and body lives in the one arena, which
+ * is sized to exactly fit them. */
+typedef struct {
+    b64_pem_entry_t *entries;
+    size_t count;
+    uint8_t *arena;
+} b64_pem_t;
+
+
+/**
+ * Decodes every block of a PEM bundle (RFC 7468), such as a CA certificate
+ * file, in a single pass.  The bodies are decoded straight into one arena,
+ * so the whole bundle costs two allocations instead of one or more per block.
+ *
+ * Text outside of the blocks is ignored.  Inside a block, line breaks and
+ * whitespace at the end of lines are skipped; the body must otherwise be
+ * standard, padded base64.  The END label must match the BEGIN label, and a
+ * label may not contain a '\0'.
+ *
+ * @note: On success the caller must release the result with b64_pem_free().
+ *        On failure nothing needs to be released.
+ *
+ * @param pem  pointer to the bundle text
+ * @param len  size of the bundle in bytes
+ * @param out  where the blocks are placed
+ *
+ * @return the number of blocks decoded, or 0 if there are none or the bundle
+ *         is malformed
+ */
+size_t b64_pem_decode(const uint8_t *pem, size_t len, b64_pem_t *out);
+
+
+/**
+ * Frees the blocks and arena of a decoded bundle and empties it.
+ *
+ * @param pem  the bundle to free (NULL is ignored)
+ */
+void b64_pem_free(b64_pem_t *pem);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BASE64_PEM__ */
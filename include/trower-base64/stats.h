@@ -0,0 +1,125 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+#ifndef __BASE64_STATS__
+#define __BASE64_STATS__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*----------------------------------------------------------------------------*/
+/*                                 Statistics                                 */
+/*----------------------------------------------------------------------------*/
+
+/* The statistics are only gathered if the library is built with the meson
+ * option 'stats' enabled.  Otherwise the counters are not compiled in at all,
+ * b64_stats_snapshot() reports enabled == 0 with every counter at 0 and
+ * b64_stats_reset() does nothing. */
+
+/* The public functions that are tracked, one slot each.  The buffer size
+ * helpers are not tracked. */
+enum b64_stats_fn {
+    B64_STATS_ENCODE = 0,
+    B64_STATS_DECODE,
+    B64_STATS_ENCODE_WITH_ALLOC,
+    B64_STATS_DECODE_WITH_ALLOC,
+    B64_STATS_URL_ENCODE,
+    B64_STATS_URL_DECODE,
+    B64_STATS_URL_ENCODE_WITH_ALLOC,
+    B64_STATS_URL_DECODE_WITH_ALLOC,
+    B64_STATS_ENCODE_APPEND,
+    B64_STATS_DECODE_APPEND,
+    B64_STATS_URL_ENCODE_APPEND,
+    B64_STATS_URL_DECODE_APPEND,
+    B64_STATS_DECODE_JSON,
+    B64_STATS_URL_DECODE_JSON,
+    B64_STATS_DECODE_FLAGS,
+    B64_STATS_DECODE_FLAGS_WITH_ALLOC,
+    B64_STATS_ENCODE_UTF16,
+    B64_STATS_DECODE_UTF16,
+    B64_STATS_URL_ENCODE_UTF16,
+    B64_STATS_URL_DECODE_UTF16,
+    B64_STATS_DECODE_CHUNKED,
+
+    B64_STATS_FN_COUNT /* Must be last */
+};
+
+/* The codec kernels a call can be served by. */
+enum b64_stats_kernel {
+    B64_STATS_KERNEL_SCALAR = 0,
+    B64_STATS_KERNEL_SWAR,
+    B64_STATS_KERNEL_TABLEFREE,
+    B64_STATS_KERNEL_CONSTANT_TIME, /* b64_decode_flags() with B64_DECODE_CONSTANT_TIME */
+
+    B64_STATS_KERNEL_COUNT /* Must be last */
+};
+
+/* Room for a kernel counter is reserved up to this many kernels. */
+#define B64_STATS_KERNEL_MAX 8
+
+/* Bucket 0 counts zero length inputs, bucket n counts the input lengths in
+ * the range [2^(n-1), 2^n). */
+#define B64_STATS_SIZE_BUCKETS 65
+
+typedef struct {
+    uint64_t calls;  /* number of calls */
+    uint64_t bytes;  /* total input length of all calls */
+    uint64_t errors; /* number of calls that failed */
+
+    /* The number of calls served by each enum b64_stats_kernel. */
+    uint64_t kernel[B64_STATS_KERNEL_MAX];
+
+    /* The number of calls by log2 of the input length. */
+    uint64_t size_log2[B64_STATS_SIZE_BUCKETS];
+} b64_stats_fn_t;
+
+typedef struct {
+    int enabled; /* 1 if the library was built with statistics */
+    b64_stats_fn_t fn[B64_STATS_FN_COUNT];
+} b64_stats_t;
+
+
+/**
+ * Sums the counters of every thread that has used the library since the last
+ * b64_stats_reset().  The counters are updated without locks, so calls that
+ * are in flight on other threads may or may not be included.
+ *
+ * @param out  pointer to where the statistics should be placed
+ */
+void b64_stats_snapshot(b64_stats_t *out);
+
+
+/**
+ * Restarts all the counters from 0.
+ */
+void b64_stats_reset(void);
+
+
+/**
+ * Get the name of a tracked function, for example "b64_decode".
+ *
+ * @param fn  the function
+ *
+ * @return the name, or NULL if fn is out of range
+ */
+const char *b64_stats_fn_name(enum b64_stats_fn fn);
+
+
+/**
+ * Get the name of a kernel, for example "scalar".
+ *
+ * @param kernel  the kernel
+ *
+ * @return the name, or NULL if kernel is out of range
+ */
+const char *b64_stats_kernel_name(enum b64_stats_kernel kernel);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BASE64_STATS__ */
@@ -0,0 +1,506 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "async.h"
+#include "base64.h"
+#include "internal.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                   Macros                                   */
+/*----------------------------------------------------------------------------*/
+#ifndef __GNUC__
+#error "The async jobs require GCC or clang atomics."
+#endif
+
+/* 48 KiB of raw data (64 KiB encoded) keeps a quantum well inside L2 while
+ * making the per quantum overhead negligible. */
+#define DEFAULT_QUANTUM (48 * 1024)
+
+/* How many times a worker scans the queues for the entry it claimed before
+ * it sleeps until the next enqueue. */
+#define SCAN_TRIES 8
+
+/*----------------------------------------------------------------------------*/
+/*                               Data Structures                              */
+/*----------------------------------------------------------------------------*/
+enum op {
+    OP_ENCODE,
+    OP_DECODE,
+};
+
+struct b64_job {
+    b64_job_t *next; /* the queue link; a job is in at most one queue */
+    b64_pool_t *pool;
+
+    enum op op;
+    const uint8_t *in;
+    size_t len;
+    uint8_t *out;
+    size_t quantum; /* raw bytes per quantum */
+    size_t quanta;
+
+    b64_job_cb_t cb;
+    void *user;
+    int notify_fd;
+
+    /* Updated atomically by the workers. */
+    size_t claimed;   /* quanta handed to a worker */
+    size_t remaining; /* quanta not finished */
+    size_t produced;  /* output bytes */
+    int failed;
+
+    size_t result; /* set once the last quantum finishes */
+    int done;      /* set once the callback returns */
+    int refs; /* one for the caller, one for the pool */
+};
+
+struct queue {
+    pthread_mutex_t lock;
+    b64_job_t *head;
+    b64_job_t *tail;
+};
+
+struct worker {
+    b64_pool_t *pool;
+    size_t id;
+    pthread_t thread;
+    struct queue q;
+};
+
+struct b64_pool {
+    pthread_mutex_t lock;
+    pthread_cond_t work; /* signalled when a job is queued or on shutdown */
+    pthread_cond_t idle;  /* broadcast when a job completes */
+    pthread_cond_t moved; /* broadcast when a job is queued while a worker searches */
+
+    /* Protected by lock. */
+    size_t queued;    /* queue entries not yet claimed by a worker */
+    size_t enqueues;  /* every entry ever queued */
+    size_t searching; /* workers waiting in find() */
+    size_t active;    /* jobs not completed */
+    int shutdown;
+
+    size_t next; /* the queue the next job goes to */
+    size_t quantum;
+    size_t count;
+    struct worker *workers;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                            File Scoped Variables                           */
+/*----------------------------------------------------------------------------*/
+/* none */
+
+/*----------------------------------------------------------------------------*/
+/*                             Function Prototypes                            */
+/*----------------------------------------------------------------------------*/
+static b64_job_t *submit(b64_pool_t *pool, enum op op, const uint8_t *in, size_t len,
+                         uint8_t *out, b64_job_cb_t cb, void *user, int notify_fd);
+static void *worker_main(void *arg);
+static void run_quantum(struct worker *w, b64_job_t *job);
+static void complete(b64_job_t *job);
+static void enqueue(b64_pool_t *pool, struct queue *q, b64_job_t *job);
+static b64_job_t *dequeue(struct queue *q);
+static b64_job_t *take(struct worker *w);
+static b64_job_t *find(struct worker *w, size_t seen);
+static void release(b64_job_t *job);
+static void stop_workers(b64_pool_t *pool, size_t started);
+
+/*----------------------------------------------------------------------------*/
+/*                             External Functions                             */
+/*----------------------------------------------------------------------------*/
+b64_pool_t *b64_pool_create(const b64_pool_config_t *config)
+{
+    size_t workers = config ? config->workers : 0;
+    size_t quantum = config ? config->quantum : 0;
+    b64_pool_t *pool;
+
+    if (0 == workers) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        workers   = (0 < cpus) ? (size_t) cpus : 1;
+    }
+    if (0 == quantum) {
+        quantum = DEFAULT_QUANTUM;
+    }
+
+    /* Whole 3 byte groups, so every quantum but the last encodes unpadded. */
+    quantum -= quantum % 3;
+    if ((0 == quantum) || (SIZE_MAX / 4 < quantum)
+        || (SIZE_MAX / sizeof(struct worker) < workers))
+    {
+        return NULL;
+    }
+
+    pool = calloc(1, sizeof(b64_pool_t));
+    if (!pool) {
+        return NULL;
+    }
+
+    pool->workers = calloc(workers, sizeof(struct worker));
+    if (!pool->workers) {
+        free(pool);
+        return NULL;
+    }
+    pool->count   = workers;
+    pool->quantum = quantum;
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work, NULL);
+    pthread_cond_init(&pool->idle, NULL);
+    pthread_cond_init(&pool->moved, NULL);
+
+    for (size_t i = 0; i < workers; i++) {
+        pool->workers[i].pool = pool;
+        pool->workers[i].id   = i;
+        pthread_mutex_init(&pool->workers[i].q.lock, NULL);
+    }
+
+    for (size_t i = 0; i < workers; i++) {
+        if (0 != pthread_create(&pool->workers[i].thread, NULL, worker_main, &pool->workers[i])) {
+            stop_workers(pool, i);
+            return NULL;
+        }
+    }
+
+    return pool;
+}
+
+
+void b64_pool_destroy(b64_pool_t *pool)
+{
+    if (!pool) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    while (0 < pool->active) {
+        pthread_cond_wait(&pool->idle, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    stop_workers(pool, pool->count);
+}
+
+
+b64_job_t *b64_encode_async(b64_pool_t *pool, const uint8_t *raw, size_t len, uint8_t *out,
+                            b64_job_cb_t cb, void *user, int notify_fd)
+{
+    return submit(pool, OP_ENCODE, raw, len, out, cb, user, notify_fd);
+}
+
+
+b64_job_t *b64_decode_async(b64_pool_t *pool, const uint8_t *enc, size_t len, uint8_t *out,
+                            b64_job_cb_t cb, void *user, int notify_fd)
+{
+    return submit(pool, OP_DECODE, enc, len, out, cb, user, notify_fd);
+}
+
+
+int b64_job_done(const b64_job_t *job)
+{
+    return job ? __atomic_load_n(&job->done, __ATOMIC_ACQUIRE) : 0;
+}
+
+
+size_t b64_job_wait(b64_job_t *job)
+{
+    if (!job) {
+        return 0;
+    }
+
+    /* Completed jobs may outlive their pool, so only wait on it if needed. */
+    if (!b64_job_done(job)) {
+        b64_pool_t *pool = job->pool;
+
+        pthread_mutex_lock(&pool->lock);
+        while (!b64_job_done(job)) {
+            pthread_cond_wait(&pool->idle, &pool->lock);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    return b64_job_result(job);
+}
+
+
+size_t b64_job_result(const b64_job_t *job)
+{
+    /* The result is set once, before the callback, and is 0 until then. */
+    return job ? __atomic_load_n(&job->result, __ATOMIC_ACQUIRE) : 0;
+}
+
+
+void b64_job_free(b64_job_t *job)
+{
+    if (job) {
+        release(job);
+    }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                             Internal functions                             */
+/*----------------------------------------------------------------------------*/
+static b64_job_t *submit(b64_pool_t *pool, enum op op, const uint8_t *in, size_t len,
+                         uint8_t *out, b64_job_cb_t cb, void *user, int notify_fd)
+{
+    size_t per = pool ? ((OP_ENCODE == op) ? pool->quantum : pool->quantum / 3 * 4) : 0;
+    b64_job_t *job;
+    size_t n;
+
+    if (!pool || !in || !len || !out || ((OP_ENCODE == op) && (B64_MAX_ENCODE_LEN < len))) {
+        return NULL;
+    }
+
+    job = calloc(1, sizeof(b64_job_t));
+    if (!job) {
+        return NULL;
+    }
+
+    job->pool      = pool;
+    job->op        = op;
+    job->in        = in;
+    job->len       = len;
+    job->out       = out;
+    job->quantum   = pool->quantum;
+    job->quanta    = len / per + ((len % per) ? 1 : 0);
+    job->remaining = job->quanta;
+    job->cb        = cb;
+    job->user      = user;
+    job->notify_fd = notify_fd;
+    job->refs      = 2;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->active++;
+    n = pool->next++ % pool->count;
+    pthread_mutex_unlock(&pool->lock);
+
+    enqueue(pool, &pool->workers[n].q, job);
+
+    return job;
+}
+
+static void *worker_main(void *arg)
+{
+    struct worker *w = arg;
+    b64_pool_t *pool = w->pool;
+
+    while (1) {
+        b64_job_t *job;
+        size_t seen;
+
+        /* Claim a queue entry first, then find it. */
+        pthread_mutex_lock(&pool->lock);
+        while ((0 == pool->queued) && !pool->shutdown) {
+            pthread_cond_wait(&pool->work, &pool->lock);
+        }
+        if (0 == pool->queued) {
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        pool->queued--;
+        seen = pool->enqueues;
+        pthread_mutex_unlock(&pool->lock);
+
+        job = find(w, seen);
+        run_quantum(w, job);
+    }
+
+    return NULL;
+}
+
+/* Runs the next quantum of the job.  If more are left the job goes back on
+ * the end of this worker's queue first, so other workers can steal the next
+ * quantum and jobs that were queued meanwhile get their turn. */
+static void run_quantum(struct worker *w, b64_job_t *job)
+{
+    size_t q = __atomic_fetch_add(&job->claimed, 1, __ATOMIC_RELAXED);
+    size_t off, n, rv;
+
+    if (q + 1 < job->quanta) {
+        enqueue(w->pool, &w->q, job);
+    }
+
+    if (OP_ENCODE == job->op) {
+        off = q * job->quantum;
+        n   = (job->quantum < job->len - off) ? job->quantum : job->len - off;
+        b64_std_encode(&job->in[off], n, &job->out[off / 3 * 4]);
+    } else {
+        size_t per = job->quantum / 3 * 4;
+
+        off = q * per;
+        n   = (per < job->len - off) ? per : job->len - off;
+        rv  = b64_std_decode(&job->in[off], n, &job->out[q * job->quantum]);
+
+        /* Only the last quantum may be padded. */
+        if ((0 == rv) || ((q + 1 < job->quanta) && (rv != job->quantum))) {
+            __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+        }
+        __atomic_fetch_add(&job->produced, rv, __ATOMIC_RELAXED);
+    }
+
+    /* The acquire/release pair makes every quantum's output visible to the
+     * worker that completes the job. */
+    if (1 == __atomic_fetch_sub(&job->remaining, 1, __ATOMIC_ACQ_REL)) {
+        complete(job);
+    }
+}
+
+static void complete(b64_job_t *job)
+{
+    b64_pool_t *pool = job->pool;
+    int fd           = job->notify_fd;
+    size_t result    = 0;
+
+    if (!__atomic_load_n(&job->failed, __ATOMIC_RELAXED)) {
+        result = (OP_ENCODE == job->op) ? b64_get_encoded_buffer_size(job->len)
+                                        : __atomic_load_n(&job->produced, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&job->result, result, __ATOMIC_RELEASE);
+
+    if (job->cb) {
+        job->cb(job, job->user);
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    __atomic_store_n(&job->done, 1, __ATOMIC_RELEASE);
+    pool->active--;
+    pthread_cond_broadcast(&pool->idle);
+    pthread_mutex_unlock(&pool->lock);
+
+    if (0 <= fd) {
+        uint64_t one = 1;
+        ssize_t rv   = write(fd, &one, sizeof(one));
+
+        (void) rv; /* Nothing useful can be done if the caller's fd is gone. */
+    }
+
+    release(job);
+}
+
+static void enqueue(b64_pool_t *pool, struct queue *q, b64_job_t *job)
+{
+    job->next = NULL;
+
+    pthread_mutex_lock(&q->lock);
+    if (q->tail) {
+        q->tail->next = job;
+    } else {
+        q->head = job;
+    }
+    q->tail = job;
+    pthread_mutex_unlock(&q->lock);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->queued++;
+    pool->enqueues++;
+    pthread_cond_signal(&pool->work);
+    if (pool->searching) {
+        pthread_cond_broadcast(&pool->moved);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+static b64_job_t *dequeue(struct queue *q)
+{
+    b64_job_t *job;
+
+    pthread_mutex_lock(&q->lock);
+    job = q->head;
+    if (job) {
+        q->head = job->next;
+        if (!q->head) {
+            q->tail = NULL;
+        }
+    }
+    pthread_mutex_unlock(&q->lock);
+
+    return job;
+}
+
+/* Takes the oldest entry from this worker's queue, or steals the oldest from
+ * the next worker that has one. */
+static b64_job_t *take(struct worker *w)
+{
+    b64_pool_t *pool = w->pool;
+
+    for (size_t i = 0; i < pool->count; i++) {
+        b64_job_t *job = dequeue(&pool->workers[(w->id + i) % pool->count].q);
+
+        if (job) {
+            return job;
+        }
+    }
+
+    return NULL;
+}
+
+/* Every claimed entry is in some queue, so a scan only misses when entries
+ * are requeued behind it while other workers take the ones ahead.  That
+ * needs an enqueue after seen, the count when the scan started, so after a
+ * few tries the worker sleeps until there is one and scans again. */
+static b64_job_t *find(struct worker *w, size_t seen)
+{
+    b64_pool_t *pool = w->pool;
+    b64_job_t *job;
+
+    for (int i = 0; i < SCAN_TRIES; i++) {
+        job = take(w);
+        if (job) {
+            return job;
+        }
+    }
+
+    while (1) {
+        pthread_mutex_lock(&pool->lock);
+        pool->searching++;
+        while (seen == pool->enqueues) {
+            pthread_cond_wait(&pool->moved, &pool->lock);
+        }
+        pool->searching--;
+        seen = pool->enqueues;
+        pthread_mutex_unlock(&pool->lock);
+
+        job = take(w);
+        if (job) {
+            return job;
+        }
+    }
+}
+
+static void release(b64_job_t *job)
+{
+    if (1 == __atomic_fetch_sub(&job->refs, 1, __ATOMIC_ACQ_REL)) {
+        free(job);
+    }
+}
+
+static void stop_workers(b64_pool_t *pool, size_t started)
+{
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+    for (size_t i = 0; i < pool->count; i++) {
+        pthread_mutex_destroy(&pool->workers[i].q.lock);
+    }
+
+    pthread_cond_destroy(&pool->moved);
+    pthread_cond_destroy(&pool->idle);
+    pthread_cond_destroy(&pool->work);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->workers);
+    free(pool);
+}
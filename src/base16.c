@@ -0,0 +1,251 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "base16.h"
+#include "internal.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                   Macros                                   */
+/*----------------------------------------------------------------------------*/
+/* none */
+
+/*----------------------------------------------------------------------------*/
+/*                               Data Structures                              */
+/*----------------------------------------------------------------------------*/
+/* none */
+
+/*----------------------------------------------------------------------------*/
+/*                            File Scoped Variables                           */
+/*----------------------------------------------------------------------------*/
+#ifndef B64_KERNEL_TABLEFREE
+static const char b16_enc_map[17] = "0123456789abcdef";
+
+// -1 = invalid
+// clang-format off
+static const int8_t b16_dec_map[256] = {
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x00-0x0f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x10-0x1f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x20-0x2f */
+     0, 1, 2, 3,  4, 5, 6, 7,  8, 9,-1,-1, -1,-1,-1,-1,    /* 0x30-0x3f */
+    -1,10,11,12, 13,14,15,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x40-0x4f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x50-0x5f */
+    -1,10,11,12, 13,14,15,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x60-0x6f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x70-0x7f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x80-0x8f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x90-0x9f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xa0-0xaf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xb0-0xbf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xc0-0xcf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xd0-0xdf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xe0-0xef */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xf0-0xff */
+};
+// clang-format on
+#endif /* B64_KERNEL_TABLEFREE */
+
+/*----------------------------------------------------------------------------*/
+/*                             Function Prototypes                            */
+/*----------------------------------------------------------------------------*/
+static inline uint8_t enc_nibble(unsigned val);
+static inline int dec_nibble(uint8_t c);
+
+/*----------------------------------------------------------------------------*/
+/*                             External Functions                             */
+/*----------------------------------------------------------------------------*/
+size_t b16_get_encoded_buffer_size(const size_t decoded_size)
+{
+    return decoded_size * 2;
+}
+
+
+size_t b16_get_encoded_buffer_size_checked(const size_t decoded_size, int *overflow)
+{
+    return checked_size(b16_get_encoded_buffer_size, decoded_size, B16_MAX_ENCODE_LEN, overflow);
+}
+
+
+size_t b16_get_decoded_buffer_size(const size_t encoded_size)
+{
+    return (0x01 & encoded_size) ? 0 : encoded_size / 2;
+}
+
+
+void b16_encode(const uint8_t *raw, const size_t len, uint8_t *out)
+{
+    size_t i = 0;
+
+    if (!raw || !out) {
+        return;
+    }
+
+#ifdef B64_KERNEL_SWAR
+    i = b16_swar_encode(raw, len, out);
+    out += 2 * i;
+#endif
+
+    for (; i < len; i++) {
+        *out++ = enc_nibble(raw[i] >> 4);
+        *out++ = enc_nibble(0x0f & raw[i]);
+    }
+}
+
+
+size_t b16_decode(const uint8_t *enc, const size_t len, uint8_t *out)
+{
+    size_t i = 0;
+    size_t j = 0;
+
+    if (!enc || !out || !len || (0x01 & len)) {
+        return 0;
+    }
+
+#ifdef B64_KERNEL_SWAR
+    /* The kernel stops in front of a block with a bad character, which the
+     * loop below then finds. */
+    i = b16_swar_decode(enc, len, out);
+    j = i / 2;
+#endif
+
+    for (; i < len; i += 2) {
+        int hi = dec_nibble(enc[i]);
+        int lo = dec_nibble(enc[i + 1]);
+
+        if ((hi < 0) || (lo < 0)) {
+            return 0;
+        }
+        out[j++] = (uint8_t) ((hi << 4) | lo);
+    }
+
+    return j;
+}
+
+
+uint8_t *b16_decode_with_alloc(const uint8_t *enc, size_t len, size_t *out_len)
+{
+    size_t raw_len = b16_get_decoded_buffer_size(len);
+    uint8_t *buf   = NULL;
+
+    if (out_len) {
+        *out_len = 0;
+    }
+    if (!raw_len || !enc || !out_len) {
+        return NULL;
+    }
+
+    buf = malloc(raw_len);
+    if (buf) {
+        *out_len = b16_decode(enc, len, buf);
+        if (0 == *out_len) {
+            free(buf);
+            buf = NULL;
+        }
+    }
+
+    return buf;
+}
+
+
+char *b16_encode_with_alloc(const uint8_t *raw, size_t len, size_t *out_len)
+{
+    size_t enc_len = b16_get_encoded_buffer_size(len);
+    char *buf      = NULL;
+
+    if (out_len) {
+        *out_len = 0;
+    }
+    if (!enc_len || !raw || (B16_MAX_ENCODE_LEN < len)) {
+        return NULL;
+    }
+
+    buf = malloc(enc_len + 1);
+    if (buf) {
+        b16_encode(raw, len, (uint8_t *) buf);
+        buf[enc_len] = '\0';
+        if (out_len) {
+            *out_len = enc_len;
+        }
+    }
+
+    return buf;
+}
+
+
+size_t b16_encode_append(b64_buf_t *dst, const uint8_t *raw, size_t len)
+{
+    size_t enc_len = b16_get_encoded_buffer_size(len);
+    uint8_t *p     = NULL;
+
+    if (!enc_len || !raw || !dst || (B16_MAX_ENCODE_LEN < len)) {
+        return 0;
+    }
+
+    p = b64_buf_reserve(dst, enc_len);
+    if (!p) {
+        return 0;
+    }
+
+    b16_encode(raw, len, p);
+    dst->len += enc_len;
+
+    return enc_len;
+}
+
+
+size_t b16_decode_append(b64_buf_t *dst, const uint8_t *enc, size_t len)
+{
+    size_t raw_len = b16_get_decoded_buffer_size(len);
+    uint8_t *p     = NULL;
+
+    if (!raw_len || !enc || !dst) {
+        return 0;
+    }
+
+    p = b64_buf_reserve(dst, raw_len);
+    if (!p) {
+        return 0;
+    }
+
+    raw_len = b16_decode(enc, len, p);
+    dst->len += raw_len;
+
+    return raw_len;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                             Internal functions                             */
+/*----------------------------------------------------------------------------*/
+
+#ifndef B64_KERNEL_TABLEFREE
+static inline uint8_t enc_nibble(unsigned val)
+{
+    return (uint8_t) b16_enc_map[val];
+}
+
+/* Returns the value of the hex digit, or -1. */
+static inline int dec_nibble(uint8_t c)
+{
+    return b16_dec_map[c];
+}
+#else
+static inline uint8_t enc_nibble(unsigned val)
+{
+    return (uint8_t) (val + '0' + (in_range((int) val, 10, 15) & ('a' - '0' - 10)));
+}
+
+static inline int dec_nibble(uint8_t c)
+{
+    unsigned digit = in_range(c, '0', '9');
+    unsigned upper = in_range(c, 'A', 'F');
+    unsigned lower = in_range(c, 'a', 'f');
+    unsigned valid = digit | upper | lower;
+    unsigned val   = (digit & (c - '0')) | (upper & (c - 'A' + 10)) | (lower & (c - 'a' + 10));
+
+    /* -1 if nothing matched */
+    return (int) (valid & val) - (int) (1 & ~valid);
+}
+#endif
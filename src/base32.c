@@ -0,0 +1,465 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "base32.h"
+#include "internal.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                   Macros                                   */
+/*----------------------------------------------------------------------------*/
+/* none */
+
+/*----------------------------------------------------------------------------*/
+/*                               Data Structures                              */
+/*----------------------------------------------------------------------------*/
+
+/* Both alphabets are one run of letters and one run of digits, so the
+ * arithmetic kernels only need to know where each run starts. */
+struct alphabet {
+#ifndef B64_KERNEL_TABLEFREE
+    const char *enc;   /* 32 characters */
+    const int8_t *dec; /* -1 = invalid */
+#endif
+    uint8_t letter; /* the value of 'A' */
+    uint8_t count;  /* the number of letters */
+    uint8_t zero;   /* the first digit */
+    uint8_t digit;  /* the value of zero */
+    int hex;        /* selects the SWAR kernel's alphabet */
+};
+
+/*----------------------------------------------------------------------------*/
+/*                            File Scoped Variables                           */
+/*----------------------------------------------------------------------------*/
+#ifndef B64_KERNEL_TABLEFREE
+static const char b32_enc_map[33]    = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+static const char b32hex_enc_map[33] = "0123456789ABCDEFGHIJKLMNOPQRSTUV";
+
+// -1 = invalid
+// clang-format off
+static const int8_t b32_dec_map[256] = {
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x00-0x0f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x10-0x1f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x20-0x2f */
+    -1,-1,26,27, 28,29,30,31, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x30-0x3f */
+    -1, 0, 1, 2,  3, 4, 5, 6,  7, 8, 9,10, 11,12,13,14,    /* 0x40-0x4f */
+    15,16,17,18, 19,20,21,22, 23,24,25,-1, -1,-1,-1,-1,    /* 0x50-0x5f */
+    -1, 0, 1, 2,  3, 4, 5, 6,  7, 8, 9,10, 11,12,13,14,    /* 0x60-0x6f */
+    15,16,17,18, 19,20,21,22, 23,24,25,-1, -1,-1,-1,-1,    /* 0x70-0x7f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x80-0x8f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x90-0x9f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xa0-0xaf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xb0-0xbf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xc0-0xcf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xd0-0xdf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xe0-0xef */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xf0-0xff */
+};
+// clang-format on
+
+// -1 = invalid
+// clang-format off
+static const int8_t b32hex_dec_map[256] = {
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x00-0x0f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x10-0x1f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x20-0x2f */
+     0, 1, 2, 3,  4, 5, 6, 7,  8, 9,-1,-1, -1,-1,-1,-1,    /* 0x30-0x3f */
+    -1,10,11,12, 13,14,15,16, 17,18,19,20, 21,22,23,24,    /* 0x40-0x4f */
+    25,26,27,28, 29,30,31,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x50-0x5f */
+    -1,10,11,12, 13,14,15,16, 17,18,19,20, 21,22,23,24,    /* 0x60-0x6f */
+    25,26,27,28, 29,30,31,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x70-0x7f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x80-0x8f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x90-0x9f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xa0-0xaf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xb0-0xbf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xc0-0xcf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xd0-0xdf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xe0-0xef */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xf0-0xff */
+};
+// clang-format on
+#endif /* B64_KERNEL_TABLEFREE */
+
+static const struct alphabet b32_std = {
+#ifndef B64_KERNEL_TABLEFREE
+    .enc = b32_enc_map,
+    .dec = b32_dec_map,
+#endif
+    .letter = 0,
+    .count  = 26,
+    .zero   = '2',
+    .digit  = 26,
+    .hex    = 0,
+};
+
+static const struct alphabet b32_hex = {
+#ifndef B64_KERNEL_TABLEFREE
+    .enc = b32hex_enc_map,
+    .dec = b32hex_dec_map,
+#endif
+    .letter = 10,
+    .count  = 22,
+    .zero   = '0',
+    .digit  = 0,
+    .hex    = 1,
+};
+
+/* The bytes held by a final group of n characters, or -1 if no group can be
+ * that long. */
+static const int8_t tail_bytes[8] = { 0, -1, 1, -1, 2, 3, -1, 4 };
+
+/*----------------------------------------------------------------------------*/
+/*                             Function Prototypes                            */
+/*----------------------------------------------------------------------------*/
+static void encode(const struct alphabet *a, const uint8_t *in, size_t len, uint8_t *out);
+static size_t decode(const struct alphabet *a, const uint8_t *in, size_t len, uint8_t *out);
+static size_t body_len(const uint8_t *in, size_t len);
+static size_t body_bytes(size_t body);
+static uint8_t *decode_w_alloc(const struct alphabet *a, const uint8_t *enc, size_t len,
+                               size_t *out_len);
+static char *encode_w_alloc(const struct alphabet *a, const uint8_t *raw, size_t len,
+                            size_t *out_len);
+static size_t decode_append(const struct alphabet *a, b64_buf_t *dst, const uint8_t *enc,
+                            size_t len);
+static size_t encode_append(const struct alphabet *a, b64_buf_t *dst, const uint8_t *raw,
+                            size_t len);
+static inline uint8_t enc_char(const struct alphabet *a, unsigned val);
+static inline int dec_char(const struct alphabet *a, uint8_t c);
+
+/*----------------------------------------------------------------------------*/
+/*                             External Functions                             */
+/*----------------------------------------------------------------------------*/
+size_t b32_get_encoded_buffer_size(const size_t decoded_size)
+{
+    return ((decoded_size + 4) / 5) * 8;
+}
+
+
+size_t b32_get_encoded_buffer_size_checked(const size_t decoded_size, int *overflow)
+{
+    return checked_size(b32_get_encoded_buffer_size, decoded_size, B32_MAX_ENCODE_LEN, overflow);
+}
+
+
+size_t b32_get_decoded_buffer_size(const size_t encoded_size)
+{
+    int tail = tail_bytes[0x07 & encoded_size];
+
+    return (tail < 0) ? 0 : (encoded_size / 8) * 5 + (size_t) tail;
+}
+
+
+void b32_encode(const uint8_t *raw, const size_t len, uint8_t *out)
+{
+    encode(&b32_std, raw, len, out);
+}
+
+
+size_t b32_decode(const uint8_t *enc, const size_t len, uint8_t *out)
+{
+    return decode(&b32_std, enc, len, out);
+}
+
+
+uint8_t *b32_decode_with_alloc(const uint8_t *enc, size_t len, size_t *out_len)
+{
+    return decode_w_alloc(&b32_std, enc, len, out_len);
+}
+
+
+char *b32_encode_with_alloc(const uint8_t *raw, size_t len, size_t *out_len)
+{
+    return encode_w_alloc(&b32_std, raw, len, out_len);
+}
+
+
+size_t b32_encode_append(b64_buf_t *dst, const uint8_t *raw, size_t len)
+{
+    return encode_append(&b32_std, dst, raw, len);
+}
+
+
+size_t b32_decode_append(b64_buf_t *dst, const uint8_t *enc, size_t len)
+{
+    return decode_append(&b32_std, dst, enc, len);
+}
+
+
+void b32hex_encode(const uint8_t *raw, const size_t len, uint8_t *out)
+{
+    encode(&b32_hex, raw, len, out);
+}
+
+
+size_t b32hex_decode(const uint8_t *enc, const size_t len, uint8_t *out)
+{
+    return decode(&b32_hex, enc, len, out);
+}
+
+
+uint8_t *b32hex_decode_with_alloc(const uint8_t *enc, size_t len, size_t *out_len)
+{
+    return decode_w_alloc(&b32_hex, enc, len, out_len);
+}
+
+
+char *b32hex_encode_with_alloc(const uint8_t *raw, size_t len, size_t *out_len)
+{
+    return encode_w_alloc(&b32_hex, raw, len, out_len);
+}
+
+
+size_t b32hex_encode_append(b64_buf_t *dst, const uint8_t *raw, size_t len)
+{
+    return encode_append(&b32_hex, dst, raw, len);
+}
+
+
+size_t b32hex_decode_append(b64_buf_t *dst, const uint8_t *enc, size_t len)
+{
+    return decode_append(&b32_hex, dst, enc, len);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                             Internal functions                             */
+/*----------------------------------------------------------------------------*/
+
+static void encode(const struct alphabet *a, const uint8_t *in, size_t len, uint8_t *out)
+{
+    size_t i = 0;
+    size_t j = 0;
+
+    if (!in || !out) {
+        return;
+    }
+
+#ifdef B64_KERNEL_SWAR
+    i = b32_swar_encode(in, len, out, a->hex);
+    j = (i / 5) * 8;
+#endif
+
+    for (; i + 5 <= len; i += 5) {
+        uint64_t bits = ((uint64_t) in[i] << 32) | ((uint64_t) in[i + 1] << 24)
+                      | ((uint64_t) in[i + 2] << 16) | ((uint64_t) in[i + 3] << 8) | in[i + 4];
+
+        for (int k = 35; 0 <= k; k -= 5) {
+            out[j++] = enc_char(a, 0x1f & (unsigned) (bits >> k));
+        }
+    }
+
+    /* The last 1-4 bytes, zero filled to a whole character, then padded. */
+    if (i < len) {
+        uint64_t bits = 0;
+        size_t n      = len - i;
+        size_t chars  = (n * 8 + 4) / 5;
+
+        for (size_t k = 0; k < 5; k++) {
+            bits = (bits << 8) | ((k < n) ? in[i + k] : 0);
+        }
+        for (size_t k = 0; k < 8; k++) {
+            out[j++] = (k < chars) ? enc_char(a, 0x1f & (unsigned) (bits >> (35 - 5 * k))) : '=';
+        }
+    }
+}
+
+static size_t decode(const struct alphabet *a, const uint8_t *in, size_t len, uint8_t *out)
+{
+    size_t body = body_len(in, len);
+    uint32_t bits = 0;
+    int bit_count = 0;
+    size_t i      = 0;
+    size_t j      = 0;
+
+    if (!body || !out) {
+        return 0;
+    }
+
+#ifdef B64_KERNEL_SWAR
+    /* The kernel stops in front of the first block it can't translate and
+     * leaves it to the loop below, which finds the bad character. */
+    i = b32_swar_decode(in, body, out, a->hex);
+    j = (i / 8) * 5;
+#endif
+
+    for (; i < body; i++) {
+        int val = dec_char(a, in[i]);
+
+        if (val < 0) {
+            return 0;
+        }
+        bits = (bits << 5) | (uint32_t) val;
+        bit_count += 5;
+
+        if (8 <= bit_count) {
+            out[j++] = (uint8_t) (0x0ff & (bits >> (bit_count - 8)));
+            bit_count -= 8;
+        }
+    }
+
+    return j;
+}
+
+/* Returns the length of the input without its padding, or 0 if the length
+ * or padding is invalid. */
+static size_t body_len(const uint8_t *in, size_t len)
+{
+    size_t padding = 0;
+
+    if (!in || !len) {
+        return 0;
+    }
+
+    while ((padding < len) && ('=' == in[len - 1 - padding])) {
+        padding++;
+    }
+
+    /* Padding only ever completes the final group of 8. */
+    if (padding && ((0 != (0x07 & len)) || (6 < padding))) {
+        return 0;
+    }
+
+    len -= padding;
+    if (tail_bytes[0x07 & len] < 0) {
+        return 0;
+    }
+
+    return len;
+}
+
+/* The exact number of bytes an unpadded body decodes to. */
+static size_t body_bytes(size_t body)
+{
+    return (body / 8) * 5 + (size_t) tail_bytes[0x07 & body];
+}
+
+static uint8_t *decode_w_alloc(const struct alphabet *a, const uint8_t *enc, size_t len,
+                               size_t *out_len)
+{
+    size_t body  = body_len(enc, len);
+    uint8_t *buf = NULL;
+
+    if (out_len) {
+        *out_len = 0;
+    }
+    if (!body || !out_len) {
+        return NULL;
+    }
+
+    buf = malloc(body_bytes(body));
+    if (buf) {
+        *out_len = decode(a, enc, len, buf);
+        if (0 == *out_len) {
+            free(buf);
+            buf = NULL;
+        }
+    }
+
+    return buf;
+}
+
+static char *encode_w_alloc(const struct alphabet *a, const uint8_t *raw, size_t len,
+                            size_t *out_len)
+{
+    size_t enc_len = b32_get_encoded_buffer_size(len);
+    char *buf      = NULL;
+
+    if (out_len) {
+        *out_len = 0;
+    }
+    if (!enc_len || !raw || (B32_MAX_ENCODE_LEN < len)) {
+        return NULL;
+    }
+
+    buf = malloc(enc_len + 1);
+    if (buf) {
+        encode(a, raw, len, (uint8_t *) buf);
+        buf[enc_len] = '\0';
+        if (out_len) {
+            *out_len = enc_len;
+        }
+    }
+
+    return buf;
+}
+
+static size_t decode_append(const struct alphabet *a, b64_buf_t *dst, const uint8_t *enc,
+                            size_t len)
+{
+    size_t body = dst ? body_len(enc, len) : 0;
+    uint8_t *p  = NULL;
+    size_t raw_len;
+
+    if (!body) {
+        return 0;
+    }
+
+    p = b64_buf_reserve(dst, body_bytes(body));
+    if (!p) {
+        return 0;
+    }
+
+    raw_len = decode(a, enc, len, p);
+    dst->len += raw_len;
+
+    return raw_len;
+}
+
+static size_t encode_append(const struct alphabet *a, b64_buf_t *dst, const uint8_t *raw,
+                            size_t len)
+{
+    size_t enc_len = b32_get_encoded_buffer_size(len);
+    uint8_t *p     = NULL;
+
+    if (!enc_len || !raw || !dst || (B32_MAX_ENCODE_LEN < len)) {
+        return 0;
+    }
+
+    p = b64_buf_reserve(dst, enc_len);
+    if (!p) {
+        return 0;
+    }
+
+    encode(a, raw, len, p);
+    dst->len += enc_len;
+
+    return enc_len;
+}
+
+#ifndef B64_KERNEL_TABLEFREE
+static inline uint8_t enc_char(const struct alphabet *a, unsigned val)
+{
+    return (uint8_t) a->enc[val];
+}
+
+/* Returns the value of the character, or -1 if it is not part of the
+ * alphabet. */
+static inline int dec_char(const struct alphabet *a, uint8_t c)
+{
+    return a->dec[c];
+}
+#else
+/* The same range compares as the base64 table free kernel. */
+static inline uint8_t enc_char(const struct alphabet *a, unsigned val)
+{
+    unsigned letters = in_range((int) val, a->letter, a->letter + a->count - 1);
+
+    return (uint8_t) ((letters & (val + 'A' - a->letter)) | (~letters & (val + a->zero - a->digit)));
+}
+
+static inline int dec_char(const struct alphabet *a, uint8_t c)
+{
+    unsigned upper  = in_range(c, 'A', 'A' + a->count - 1);
+    unsigned lower  = in_range(c, 'a', 'a' + a->count - 1);
+    unsigned digits = in_range(c, a->zero, a->zero + 31 - a->count);
+    unsigned valid  = upper | lower | digits;
+    unsigned val    = (upper & (c - 'A' + a->letter)) | (lower & (c - 'a' + a->letter))
+                 | (digits & (c - a->zero + a->digit));
+
+    /* -1 if nothing matched */
+    return (int) (valid & val) - (int) (1 & ~valid);
+}
+#endif
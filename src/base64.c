@@ -4,33 +4,203 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include "base64.h"
+#include "internal.h"
 
 /*----------------------------------------------------------------------------*/
 /*                                   Macros                                   */
 /*----------------------------------------------------------------------------*/
-/* none */
+
+/* The number of unescaped characters staged at a time by decode_json().  This
+ * must be a multiple of 4. */
+#define JSON_BLOCK_SIZE 256
+
+/* The number of characters b64_decode_chunked() decodes at a time, which is
+ * a multiple of 4 that decodes to exactly B64_DECODE_CHUNK_MAX bytes. */
+#define CHUNK_SIZE ((B64_DECODE_CHUNK_MAX / 3) * 4)
+
+/* The kernel that serves a decode with these flags: constant time decodes
+ * never use the build's kernel. */
+#define FLAGS_KERNEL(flags)                                                                \
+    ((B64_DECODE_CONSTANT_TIME & (flags)) ? B64_STATS_KERNEL_CONSTANT_TIME : STATS_KERNEL)
+
+/* The UTF-16 loops translate a character at a time, so the SWAR kernel never
+ * serves them. */
+#ifdef B64_KERNEL_SWAR
+#define UTF16_KERNEL B64_STATS_KERNEL_SCALAR
+#else
+#define UTF16_KERNEL STATS_KERNEL
+#endif
 
 /*----------------------------------------------------------------------------*/
 /*                               Data Structures                              */
 /*----------------------------------------------------------------------------*/
-/* none */
+
+/* Everything the kernels need to know about an alphabet.  The table based
+ * loops use enc/dec; the arithmetic kernels only need the two characters that
+ * are not letters or digits.  c62/c63 hold two entries so the mixed alphabet
+ * can accept both spellings; single alphabets repeat the character. */
+struct alphabet {
+#ifndef B64_KERNEL_TABLEFREE
+    const char *enc;   /* 64 characters then the pad, or '\0' for none */
+    const int8_t *dec; /* -1 = invalid, -2 = padding */
+#endif
+    uint8_t c62[2];
+    uint8_t c63[2];
+    uint8_t pad; /* '\0' for none */
+};
 
 /*----------------------------------------------------------------------------*/
 /*                            File Scoped Variables                           */
 /*----------------------------------------------------------------------------*/
-/* none */
+#ifndef B64_KERNEL_TABLEFREE
+static const char b64_enc_map[65]    = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/=";
+static const char b64url_enc_map[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_\0";
+
+// -1 = invalid
+// -2 = padding
+// clang-format off
+static const int8_t b64_dec_map[256] = {
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x00-0x0f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x10-0x1f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,62, -1,-1,-1,63,    /* 0x20-0x2f */
+    52,53,54,55, 56,57,58,59, 60,61,-1,-1, -1,-2,-1,-1,    /* 0x30-0x3f */
+    -1, 0, 1, 2,  3, 4, 5, 6,  7, 8, 9,10, 11,12,13,14,    /* 0x40-0x4f */
+    15,16,17,18, 19,20,21,22, 23,24,25,-1, -1,-1,-1,-1,    /* 0x50-0x5f */
+    -1,26,27,28, 29,30,31,32, 33,34,35,36, 37,38,39,40,    /* 0x60-0x6f */
+    41,42,43,44, 45,46,47,48, 49,50,51,-1, -1,-1,-1,-1,    /* 0x70-0x7f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x80-0x8f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x90-0x9f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xa0-0xaf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xb0-0xbf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xc0-0xcf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xd0-0xdf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xe0-0xef */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xf0-0xff */
+};
+// clang-format on
+
+// -1 = invalid
+// -2 = padding
+// clang-format off
+static const int8_t b64url_dec_map[256] = {
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x00-0x0f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x10-0x1f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,62,-1,-1,    /* 0x20-0x2f */
+    52,53,54,55, 56,57,58,59, 60,61,-1,-1, -1,-2,-1,-1,    /* 0x30-0x3f */
+    -1, 0, 1, 2,  3, 4, 5, 6,  7, 8, 9,10, 11,12,13,14,    /* 0x40-0x4f */
+    15,16,17,18, 19,20,21,22, 23,24,25,-1, -1,-1,-1,63,    /* 0x50-0x5f */
+    -1,26,27,28, 29,30,31,32, 33,34,35,36, 37,38,39,40,    /* 0x60-0x6f */
+    41,42,43,44, 45,46,47,48, 49,50,51,-1, -1,-1,-1,-1,    /* 0x70-0x7f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x80-0x8f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x90-0x9f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xa0-0xaf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xb0-0xbf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xc0-0xcf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xd0-0xdf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xe0-0xef */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xf0-0xff */
+};
+// clang-format on
+
+
+// -1 = invalid
+// -2 = padding
+// clang-format off
+static const int8_t b64any_dec_map[256] = {
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x00-0x0f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x10-0x1f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,62, -1,62,-1,63,    /* 0x20-0x2f */
+    52,53,54,55, 56,57,58,59, 60,61,-1,-1, -1,-2,-1,-1,    /* 0x30-0x3f */
+    -1, 0, 1, 2,  3, 4, 5, 6,  7, 8, 9,10, 11,12,13,14,    /* 0x40-0x4f */
+    15,16,17,18, 19,20,21,22, 23,24,25,-1, -1,-1,-1,63,    /* 0x50-0x5f */
+    -1,26,27,28, 29,30,31,32, 33,34,35,36, 37,38,39,40,    /* 0x60-0x6f */
+    41,42,43,44, 45,46,47,48, 49,50,51,-1, -1,-1,-1,-1,    /* 0x70-0x7f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x80-0x8f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x90-0x9f */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xa0-0xaf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xb0-0xbf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xc0-0xcf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xd0-0xdf */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xe0-0xef */
+    -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xf0-0xff */
+};
+// clang-format on
+
+#endif /* B64_KERNEL_TABLEFREE */
+
+static const struct alphabet b64_std = {
+#ifndef B64_KERNEL_TABLEFREE
+    .enc = b64_enc_map,
+    .dec = b64_dec_map,
+#endif
+    .c62 = { '+', '+' },
+    .c63 = { '/', '/' },
+    .pad = '=',
+};
+
+static const struct alphabet b64_url = {
+#ifndef B64_KERNEL_TABLEFREE
+    .enc = b64url_enc_map,
+    .dec = b64url_dec_map,
+#endif
+    .c62 = { '-', '-' },
+    .c63 = { '_', '_' },
+    .pad = '\0',
+};
+
+static const struct alphabet b64_any = {
+#ifndef B64_KERNEL_TABLEFREE
+    .enc = b64_enc_map,
+    .dec = b64any_dec_map,
+#endif
+    .c62 = { '+', '-' },
+    .c63 = { '/', '_' },
+    .pad = '=',
+};
 
 /*----------------------------------------------------------------------------*/
 /*                             Function Prototypes                            */
 /*----------------------------------------------------------------------------*/
-static void encode(const char *map, const uint8_t *in, size_t len, uint8_t *out);
-static size_t decode(const int8_t *map, const uint8_t *in, size_t len, uint8_t *out);
-static uint8_t *decode_w_alloc(size_t(size_fn)(const size_t),
+static void std_encode(const uint8_t *raw, const size_t len, uint8_t *out);
+static void url_encode(const uint8_t *raw, const size_t len, uint8_t *out);
+static size_t std_decode(const uint8_t *enc, const size_t len, uint8_t *out);
+static size_t url_decode(const uint8_t *enc, const size_t len, uint8_t *out);
+static void encode(const struct alphabet *a, const uint8_t *in, size_t len, uint8_t *out);
+static size_t decode(const struct alphabet *a, const uint8_t *in, size_t len, uint8_t *out);
+static size_t decode_body(const struct alphabet *a, const uint8_t *in, size_t len, uint8_t *out);
+static size_t decode_body_ct(const struct alphabet *a, const uint8_t *in, size_t len,
+                             uint8_t *out);
+static void encode_utf16(const struct alphabet *a, const uint8_t *in, size_t len, uint16_t *out);
+static size_t decode_utf16(const struct alphabet *a, const uint16_t *in, size_t len, uint8_t *out);
+static const struct alphabet *flags_alphabet(unsigned flags);
+static inline uint8_t enc_char(const struct alphabet *a, unsigned val);
+static inline int dec_char(const struct alphabet *a, uint8_t c);
+static inline int ct_dec_char(const struct alphabet *a, uint8_t c);
+static size_t flags_decoded_size(size_t len, unsigned flags);
+static size_t exact_decoded_size(const struct alphabet *a, const uint8_t *enc, size_t len,
+                                 unsigned flags, int *needs_decode);
+static size_t decode_flags(const uint8_t *enc, size_t len, uint8_t *out, unsigned flags);
+static uint8_t *decode_w_alloc(size_t(size_fn)(const uint8_t *, size_t, int *),
                                size_t(decode_fn)(const uint8_t *, const size_t, uint8_t *),
                                const uint8_t *enc, size_t len, size_t *out_len);
 static char *encode_w_alloc(size_t(size_fn)(const size_t),
                             void(encode_fn)(const uint8_t *, const size_t, uint8_t *),
                             const uint8_t *enc, size_t len, size_t *out_len);
+static size_t decode_json(const struct alphabet *a,
+                          size_t(decode_fn)(const uint8_t *, const size_t, uint8_t *),
+                          const uint8_t *enc, size_t len, uint8_t *out);
+static size_t json_unescape(const uint8_t *in, size_t len, uint8_t *c);
+static size_t decode_append(size_t(size_fn)(const uint8_t *, size_t, int *),
+                            size_t(decode_fn)(const uint8_t *, const size_t, uint8_t *),
+                            b64_buf_t *dst, const uint8_t *enc, size_t len);
+static size_t encode_append(size_t(size_fn)(const size_t),
+                            void(encode_fn)(const uint8_t *, const size_t, uint8_t *),
+                            b64_buf_t *dst, const uint8_t *raw, size_t len);
+static size_t decode_chunked(const uint8_t *enc, size_t len, unsigned flags, b64_chunk_cb_t cb,
+                             void *user);
 
 /*----------------------------------------------------------------------------*/
 /*                             External Functions                             */
@@ -41,6 +211,12 @@ size_t b64_get_encoded_buffer_size(const size_t decoded_size)
 }
 
 
+size_t b64_get_encoded_buffer_size_checked(const size_t decoded_size, int *overflow)
+{
+    return checked_size(b64_get_encoded_buffer_size, decoded_size, B64_MAX_ENCODE_LEN, overflow);
+}
+
+
 size_t b64_get_decoded_buffer_size(const size_t encoded_size)
 {
     size_t rv = (encoded_size / 4) * 3;
@@ -54,6 +230,13 @@ size_t b64_get_decoded_buffer_size(const size_t encoded_size)
 }
 
 
+size_t b64_get_decoded_size(const uint8_t *enc, size_t len, int *needs_decode)
+{
+    return exact_decoded_size(&b64_std, enc, len, B64_DECODE_STANDARD | B64_DECODE_PAD_REQUIRED,
+                              needs_decode);
+}
+
+
 size_t b64url_get_encoded_buffer_size(const size_t decoded_size)
 {
     size_t remainder = decoded_size % 3;
@@ -66,6 +249,12 @@ size_t b64url_get_encoded_buffer_size(const size_t decoded_size)
 }
 
 
+size_t b64url_get_encoded_buffer_size_checked(const size_t decoded_size, int *overflow)
+{
+    return checked_size(b64url_get_encoded_buffer_size, decoded_size, B64_MAX_ENCODE_LEN, overflow);
+}
+
+
 size_t b64url_get_decoded_buffer_size(const size_t encoded_size)
 {
     size_t remainder = 0x03 & encoded_size;
@@ -86,130 +275,375 @@ size_t b64url_get_decoded_buffer_size(const size_t encoded_size)
 }
 
 
-void b64_encode(const uint8_t *raw, const size_t len, uint8_t *out)
+size_t b64url_get_decoded_size(const uint8_t *enc, size_t len, int *needs_decode)
 {
-    static const char map[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/=";
+    return exact_decoded_size(&b64_url, enc, len, B64_DECODE_URL | B64_DECODE_PAD_OPTIONAL,
+                              needs_decode);
+}
 
-    encode(map, raw, len, out);
+
+void b64_encode(const uint8_t *raw, const size_t len, uint8_t *out)
+{
+    std_encode(raw, len, out);
+    STATS_RECORD(B64_STATS_ENCODE, len, 1);
 }
 
 
 void b64url_encode(const uint8_t *raw, const size_t len, uint8_t *out)
 {
-    static const char map[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_\0";
-
-    encode(map, raw, len, out);
+    url_encode(raw, len, out);
+    STATS_RECORD(B64_STATS_URL_ENCODE, len, 1);
 }
 
 
 size_t b64_decode(const uint8_t *enc, const size_t len, uint8_t *out)
 {
-    // -1 = invalid
-    // -2 = padding
-    // clang-format off
-    static const int8_t map[256] = {
-        -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x00-0x0f */
-        -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x10-0x1f */
-        -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,62, -1,-1,-1,63,    /* 0x20-0x2f */
-        52,53,54,55, 56,57,58,59, 60,61,-1,-1, -1,-2,-1,-1,    /* 0x30-0x3f */
-        -1, 0, 1, 2,  3, 4, 5, 6,  7, 8, 9,10, 11,12,13,14,    /* 0x40-0x4f */
-        15,16,17,18, 19,20,21,22, 23,24,25,-1, -1,-1,-1,-1,    /* 0x50-0x5f */
-        -1,26,27,28, 29,30,31,32, 33,34,35,36, 37,38,39,40,    /* 0x60-0x6f */
-        41,42,43,44, 45,46,47,48, 49,50,51,-1, -1,-1,-1,-1,    /* 0x70-0x7f */
-        -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x80-0x8f */
-        -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x90-0x9f */
-        -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xa0-0xaf */
-        -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xb0-0xbf */
-        -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xc0-0xcf */
-        -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xd0-0xdf */
-        -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xe0-0xef */
-        -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xf0-0xff */
-    };
-    // clang-format off
-    size_t max = b64_get_decoded_buffer_size( len );
-
-    if( (0 == max) || !enc || !out ) {
-        return 0;
-    }
+    size_t rv = std_decode(enc, len, out);
 
-    return decode( map, enc, len, out );
-}
-
-
-size_t b64url_decode( const uint8_t *enc, const size_t len, uint8_t *out )
-{
-    // -1 = invalid
-    // -2 = padding
-    // clang-format off
-    static const int8_t map[256] = {
-        -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x00-0x0f */
-        -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x10-0x1f */
-        -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,62,-1,-1,    /* 0x20-0x2f */
-        52,53,54,55, 56,57,58,59, 60,61,-1,-1, -1,-2,-1,-1,    /* 0x30-0x3f */
-        -1, 0, 1, 2,  3, 4, 5, 6,  7, 8, 9,10, 11,12,13,14,    /* 0x40-0x4f */
-        15,16,17,18, 19,20,21,22, 23,24,25,-1, -1,-1,-1,63,    /* 0x50-0x5f */
-        -1,26,27,28, 29,30,31,32, 33,34,35,36, 37,38,39,40,    /* 0x60-0x6f */
-        41,42,43,44, 45,46,47,48, 49,50,51,-1, -1,-1,-1,-1,    /* 0x70-0x7f */
-        -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x80-0x8f */
-        -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0x90-0x9f */
-        -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xa0-0xaf */
-        -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xb0-0xbf */
-        -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xc0-0xcf */
-        -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xd0-0xdf */
-        -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xe0-0xef */
-        -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,    /* 0xf0-0xff */
-    };
-    // clang-format on
-    size_t max = b64url_get_decoded_buffer_size(len);
+    STATS_RECORD(B64_STATS_DECODE, len, 0 != rv);
+    return rv;
+}
 
-    if ((0 == max) || !enc || !out) {
-        return 0;
-    }
 
-    return decode(map, enc, len, out);
+size_t b64url_decode(const uint8_t *enc, const size_t len, uint8_t *out)
+{
+    size_t rv = url_decode(enc, len, out);
+
+    STATS_RECORD(B64_STATS_URL_DECODE, len, 0 != rv);
+    return rv;
 }
 
 
 uint8_t *b64_decode_with_alloc(const uint8_t *enc, size_t len, size_t *out_len)
 {
-    return decode_w_alloc(b64_get_decoded_buffer_size, b64_decode, enc, len, out_len);
+    uint8_t *rv = decode_w_alloc(b64_get_decoded_size, std_decode, enc, len, out_len);
+
+    STATS_RECORD(B64_STATS_DECODE_WITH_ALLOC, len, NULL != rv);
+    return rv;
 }
 
 
 char *b64_encode_with_alloc(const uint8_t *raw, size_t len, size_t *out_len)
 {
-    return encode_w_alloc(b64_get_encoded_buffer_size, b64_encode, raw, len, out_len);
+    char *rv = encode_w_alloc(b64_get_encoded_buffer_size, std_encode, raw, len, out_len);
+
+    STATS_RECORD(B64_STATS_ENCODE_WITH_ALLOC, len, NULL != rv);
+    return rv;
 }
 
 
 uint8_t *b64url_decode_with_alloc(const uint8_t *enc, size_t len, size_t *out_len)
 {
-    return decode_w_alloc(b64url_get_decoded_buffer_size, b64url_decode, enc, len, out_len);
+    uint8_t *rv = decode_w_alloc(b64url_get_decoded_size, url_decode, enc, len, out_len);
+
+    STATS_RECORD(B64_STATS_URL_DECODE_WITH_ALLOC, len, NULL != rv);
+    return rv;
 }
 
 
 char *b64url_encode_with_alloc(const uint8_t *raw, size_t len, size_t *out_len)
 {
-    return encode_w_alloc(b64url_get_encoded_buffer_size, b64url_encode, raw, len, out_len);
+    char *rv = encode_w_alloc(b64url_get_encoded_buffer_size, url_encode, raw, len, out_len);
+
+    STATS_RECORD(B64_STATS_URL_ENCODE_WITH_ALLOC, len, NULL != rv);
+    return rv;
+}
+
+
+size_t b64_decode_json(const uint8_t *enc, const size_t len, uint8_t *out)
+{
+    size_t rv = decode_json(&b64_std, std_decode, enc, len, out);
+
+    STATS_RECORD(B64_STATS_DECODE_JSON, len, 0 != rv);
+    return rv;
+}
+
+
+size_t b64url_decode_json(const uint8_t *enc, const size_t len, uint8_t *out)
+{
+    size_t rv = decode_json(&b64_url, url_decode, enc, len, out);
+
+    STATS_RECORD(B64_STATS_URL_DECODE_JSON, len, 0 != rv);
+    return rv;
+}
+
+
+void b64_encode_utf16(const uint8_t *raw, const size_t len, uint16_t *out)
+{
+    encode_utf16(&b64_std, raw, len, out);
+    STATS_RECORD_KERNEL(B64_STATS_ENCODE_UTF16, UTF16_KERNEL, len, 1);
+}
+
+
+size_t b64_decode_utf16(const uint16_t *enc, const size_t len, uint8_t *out)
+{
+    size_t max = b64_get_decoded_buffer_size(len);
+    size_t rv  = 0;
+
+    if ((0 != max) && enc && out) {
+        rv = decode_utf16(&b64_std, enc, len, out);
+    }
+
+    STATS_RECORD_KERNEL(B64_STATS_DECODE_UTF16, UTF16_KERNEL, len, 0 != rv);
+    return rv;
+}
+
+
+void b64url_encode_utf16(const uint8_t *raw, const size_t len, uint16_t *out)
+{
+    encode_utf16(&b64_url, raw, len, out);
+    STATS_RECORD_KERNEL(B64_STATS_URL_ENCODE_UTF16, UTF16_KERNEL, len, 1);
+}
+
+
+size_t b64url_decode_utf16(const uint16_t *enc, const size_t len, uint8_t *out)
+{
+    size_t max = b64url_get_decoded_buffer_size(len);
+    size_t rv  = 0;
+
+    if ((0 != max) && enc && out) {
+        rv = decode_utf16(&b64_url, enc, len, out);
+    }
+
+    STATS_RECORD_KERNEL(B64_STATS_URL_DECODE_UTF16, UTF16_KERNEL, len, 0 != rv);
+    return rv;
+}
+
+
+size_t b64_get_decoded_buffer_size_flags(const size_t encoded_size, unsigned flags)
+{
+    return flags_decoded_size(encoded_size, flags);
+}
+
+
+size_t b64_get_decoded_size_flags(const uint8_t *enc, size_t len, unsigned flags,
+                                  int *needs_decode)
+{
+    return exact_decoded_size(flags_alphabet(flags), enc, len, flags, needs_decode);
+}
+
+
+size_t b64_decode_flags(const uint8_t *enc, const size_t len, uint8_t *out, unsigned flags)
+{
+    size_t rv = b64_flags_decode(enc, len, out, flags);
+
+    STATS_RECORD_KERNEL(B64_STATS_DECODE_FLAGS, FLAGS_KERNEL(flags), len, 0 != rv);
+    return rv;
+}
+
+
+uint8_t *b64_decode_flags_with_alloc(const uint8_t *enc, size_t len, size_t *out_len,
+                                     unsigned flags)
+{
+    size_t raw_len = exact_decoded_size(flags_alphabet(flags), enc, len, flags, NULL);
+    uint8_t *buf   = NULL;
+
+    if (out_len) {
+        *out_len = 0;
+    }
+
+    if (raw_len && out_len) {
+        buf = malloc(raw_len * sizeof(uint8_t));
+    }
+    if (buf) {
+        *out_len = decode_flags(enc, len, buf, flags);
+        if (0 == *out_len) {
+            free(buf);
+            buf = NULL;
+        }
+    }
+
+    STATS_RECORD_KERNEL(B64_STATS_DECODE_FLAGS_WITH_ALLOC, FLAGS_KERNEL(flags), len, NULL != buf);
+    return buf;
+}
+
+
+size_t b64_encode_append(b64_buf_t *dst, const uint8_t *raw, size_t len)
+{
+    size_t rv = encode_append(b64_get_encoded_buffer_size, std_encode, dst, raw, len);
+
+    STATS_RECORD(B64_STATS_ENCODE_APPEND, len, 0 != rv);
+    return rv;
+}
+
+
+size_t b64_decode_append(b64_buf_t *dst, const uint8_t *enc, size_t len)
+{
+    size_t rv = decode_append(b64_get_decoded_size, std_decode, dst, enc, len);
+
+    STATS_RECORD(B64_STATS_DECODE_APPEND, len, 0 != rv);
+    return rv;
+}
+
+
+size_t b64url_encode_append(b64_buf_t *dst, const uint8_t *raw, size_t len)
+{
+    size_t rv = encode_append(b64url_get_encoded_buffer_size, url_encode, dst, raw, len);
+
+    STATS_RECORD(B64_STATS_URL_ENCODE_APPEND, len, 0 != rv);
+    return rv;
+}
+
+
+size_t b64url_decode_append(b64_buf_t *dst, const uint8_t *enc, size_t len)
+{
+    size_t rv = decode_append(b64url_get_decoded_size, url_decode, dst, enc, len);
+
+    STATS_RECORD(B64_STATS_URL_DECODE_APPEND, len, 0 != rv);
+    return rv;
+}
+
+
+size_t b64_decode_chunked(const uint8_t *enc, size_t len, unsigned flags, b64_chunk_cb_t cb,
+                          void *user)
+{
+    size_t rv = 0;
+
+    if (enc && cb) {
+        rv = decode_chunked(enc, len, flags, cb, user);
+    }
+
+    STATS_RECORD_KERNEL(B64_STATS_DECODE_CHUNKED, FLAGS_KERNEL(flags), len, 0 != rv);
+    return rv;
+}
+
+
+uint8_t *b64_buf_reserve(b64_buf_t *buf, size_t need)
+{
+    size_t size;
+    uint8_t *p;
+
+    if (need <= buf->size - buf->len) {
+        return &buf->data[buf->len];
+    }
+
+    if (SIZE_MAX - buf->len < need) {
+        return NULL;
+    }
+
+    size = buf->size;
+    if (size < 64) {
+        size = 64;
+    }
+    while (size < buf->len + need) {
+        if (SIZE_MAX / 2 < size) {
+            size = buf->len + need;
+            break;
+        }
+        size *= 2;
+    }
+
+    if (buf->realloc_fn) {
+        p = buf->realloc_fn(buf->data, size);
+    } else {
+        p = realloc(buf->data, size);
+    }
+    if (!p) {
+        return NULL;
+    }
+
+    buf->data = p;
+    buf->size = size;
+
+    return &buf->data[buf->len];
+}
+
+
+void b64_std_encode(const uint8_t *raw, size_t len, uint8_t *out)
+{
+    std_encode(raw, len, out);
+}
+
+
+void b64_url_encode(const uint8_t *raw, size_t len, uint8_t *out)
+{
+    url_encode(raw, len, out);
+}
+
+
+size_t b64_std_decode(const uint8_t *enc, size_t len, uint8_t *out)
+{
+    return std_decode(enc, len, out);
+}
+
+
+size_t b64_std_decode_body(const uint8_t *enc, size_t len, uint8_t *out)
+{
+    return decode_body(&b64_std, enc, len, out);
+}
+
+
+size_t b64_flags_decode(const uint8_t *enc, size_t len, uint8_t *out, unsigned flags)
+{
+    if (!enc || !out) {
+        return 0;
+    }
+
+    return decode_flags(enc, len, out, flags);
 }
 
 
 /*----------------------------------------------------------------------------*/
 /*                             Internal functions                             */
 /*----------------------------------------------------------------------------*/
-static void encode(const char *map, const uint8_t *in, size_t len, uint8_t *out)
+
+/* The uninstrumented bodies of the public codec functions.  Everything inside
+ * the library calls these so each public call is only counted once. */
+static void std_encode(const uint8_t *raw, const size_t len, uint8_t *out)
+{
+    encode(&b64_std, raw, len, out);
+}
+
+static void url_encode(const uint8_t *raw, const size_t len, uint8_t *out)
+{
+    encode(&b64_url, raw, len, out);
+}
+
+static size_t std_decode(const uint8_t *enc, const size_t len, uint8_t *out)
+{
+    size_t max = b64_get_decoded_buffer_size(len);
+
+    if ((0 == max) || !enc || !out) {
+        return 0;
+    }
+
+    return decode(&b64_std, enc, len, out);
+}
+
+static size_t url_decode(const uint8_t *enc, const size_t len, uint8_t *out)
+{
+    size_t max = b64url_get_decoded_buffer_size(len);
+
+    if ((0 == max) || !enc || !out) {
+        return 0;
+    }
+
+    return decode(&b64_url, enc, len, out);
+}
+
+static void encode(const struct alphabet *a, const uint8_t *in, size_t len, uint8_t *out)
 {
     uint32_t bits = 0;
     int bit_count = 0;
     size_t j      = 0;
 
+#ifdef B64_KERNEL_SWAR
+    /* The kernel takes whole 6 byte blocks; the loop below finishes the
+     * tail and the padding. */
+    size_t done = b64_swar_encode(in, len, out, a->c62[0], a->c63[0]);
+
+    in += done;
+    len -= done;
+    out += (done / 3) * 4;
+#endif
+
     for (size_t i = 0; i < len; i++) {
         bits = (bits << 8) | in[i];
         bit_count += 8;
 
         while (6 <= bit_count) {
             bit_count -= 6;
-            out[j++] = (uint8_t) map[0x3f & (bits >> bit_count)];
+            out[j++] = enc_char(a, 0x3f & (bits >> bit_count));
         }
     }
 
@@ -218,19 +652,166 @@ static void encode(const char *map, const uint8_t *in, size_t len, uint8_t *out)
         bits <<= 8;
         bit_count += 8;
         bit_count -= 6;
-        out[j++] = (uint8_t) map[0x3f & (bits >> bit_count)];
+        out[j++] = enc_char(a, 0x3f & (bits >> bit_count));
     }
 
     /* Pad */
-    while (('\0' != map[64]) && (0x03 & j)) {
-        out[j++] = (uint8_t) map[64];
+    while (('\0' != a->pad) && (0x03 & j)) {
+        out[j++] = a->pad;
     }
 }
 
 
-static size_t decode(const int8_t *map, const uint8_t *in, size_t len, uint8_t *out)
+static size_t decode(const struct alphabet *a, const uint8_t *in, size_t len, uint8_t *out)
 {
+    size_t padding = 0;
 
+    if ('=' == in[len - 1]) {
+        padding++;
+        if ('=' == in[len - 2]) {
+            padding++;
+        }
+
+        /* If there is padding then it should only pad to ensure the string
+         * has a multiple of 4.  Anything else is an error. */
+        if (0 != (0x03 & len)) {
+            return 0;
+        }
+    }
+
+    return decode_body(a, in, len - padding, out);
+}
+
+/* Translates the unpadded characters, returning 0 on any invalid character. */
+static size_t decode_body(const struct alphabet *a, const uint8_t *in, size_t len, uint8_t *out)
+{
+    uint32_t bits = 0;
+    int bit_count = 0;
+    size_t j      = 0;
+
+#ifdef B64_KERNEL_SWAR
+    /* The kernel stops in front of the first block it can't translate and
+     * leaves it to the loop below, which finds the bad character. */
+    size_t done = b64_swar_decode(in, len, out, a->c62, a->c63);
+
+    in += done;
+    len -= done;
+    j = (done / 4) * 3;
+#endif
+
+    for (size_t i = 0; i < len; i++) {
+        int val;
+
+        val = dec_char(a, in[i]);
+        if (val < 0) {
+            return 0;
+        }
+        bits = (bits << 6) | val;
+        bit_count += 6;
+
+        if (8 <= bit_count) {
+            out[j++] = (uint8_t) (0x0ff & (bits >> (bit_count - 8)));
+            bit_count -= 8;
+        }
+    }
+
+    return j;
+}
+
+/* The same as decode_body(), but for secrets: every character is translated
+ * arithmetically and the stores don't depend on its value, so nothing but
+ * the length decides which branches run and which memory is touched.  Errors
+ * are collected as they go and only looked at once the loop is done. */
+static size_t decode_body_ct(const struct alphabet *a, const uint8_t *in, size_t len,
+                             uint8_t *out)
+{
+    size_t whole = len & ~(size_t) 3;
+    unsigned bad = 0;
+    uint32_t bits;
+    size_t j = 0;
+    size_t i;
+
+    for (i = 0; i < whole; i += 4) {
+        int v0 = ct_dec_char(a, in[i]);
+        int v1 = ct_dec_char(a, in[i + 1]);
+        int v2 = ct_dec_char(a, in[i + 2]);
+        int v3 = ct_dec_char(a, in[i + 3]);
+
+        bad |= (unsigned) (v0 | v1 | v2 | v3);
+        bits = ((uint32_t) (0x3f & v0) << 18) | ((uint32_t) (0x3f & v1) << 12)
+             | ((uint32_t) (0x3f & v2) << 6) | (uint32_t) (0x3f & v3);
+
+        out[j++] = (uint8_t) (bits >> 16);
+        out[j++] = (uint8_t) (bits >> 8);
+        out[j++] = (uint8_t) bits;
+    }
+
+    /* 2 or 3 characters are left for 1 or 2 bytes. */
+    if (i < len) {
+        int v0 = ct_dec_char(a, in[i]);
+        int v1 = ct_dec_char(a, in[i + 1]);
+        int v2 = (i + 2 < len) ? ct_dec_char(a, in[i + 2]) : 0;
+
+        bad |= (unsigned) (v0 | v1 | v2);
+        bits = ((uint32_t) (0x3f & v0) << 18) | ((uint32_t) (0x3f & v1) << 12)
+             | ((uint32_t) (0x3f & v2) << 6);
+
+        out[j++] = (uint8_t) (bits >> 16);
+        if (i + 2 < len) {
+            out[j++] = (uint8_t) (bits >> 8);
+        }
+    }
+
+    /* Only a negative value sets the bits above the 6 a value uses. */
+    if (~0x3fu & bad) {
+        memset(out, 0, j);
+        return 0;
+    }
+
+    return j;
+}
+
+/* The same as encode(), but widening each character to a code unit as it is
+ * stored rather than in a second pass. */
+static void encode_utf16(const struct alphabet *a, const uint8_t *in, size_t len, uint16_t *out)
+{
+    size_t i = 0;
+    size_t j = 0;
+
+    for (; i + 3 <= len; i += 3) {
+        uint32_t bits = ((uint32_t) in[i] << 16) | ((uint32_t) in[i + 1] << 8) | in[i + 2];
+
+        out[j++] = enc_char(a, 0x3f & (bits >> 18));
+        out[j++] = enc_char(a, 0x3f & (bits >> 12));
+        out[j++] = enc_char(a, 0x3f & (bits >> 6));
+        out[j++] = enc_char(a, 0x3f & bits);
+    }
+
+    if (i < len) {
+        uint32_t bits = (uint32_t) in[i] << 16;
+
+        if (i + 1 < len) {
+            bits |= (uint32_t) in[i + 1] << 8;
+        }
+
+        out[j++] = enc_char(a, 0x3f & (bits >> 18));
+        out[j++] = enc_char(a, 0x3f & (bits >> 12));
+        if (i + 1 < len) {
+            out[j++] = enc_char(a, 0x3f & (bits >> 6));
+        }
+    }
+
+    /* Pad */
+    while (('\0' != a->pad) && (0x03 & j)) {
+        out[j++] = a->pad;
+    }
+}
+
+/* The same as decode(), but narrowing each code unit as it is read.  Units
+ * above 0xff are forced invalid and the map already rejects 0x80-0xff, so
+ * there is no separate validation scan. */
+static size_t decode_utf16(const struct alphabet *a, const uint16_t *in, size_t len, uint8_t *out)
+{
     uint32_t bits  = 0;
     int bit_count  = 0;
     size_t padding = 0;
@@ -252,9 +833,9 @@ static size_t decode(const int8_t *map, const uint8_t *in, size_t len, uint8_t *
     len -= padding;
 
     for (size_t i = 0; i < len; i++) {
-        int8_t val;
+        uint16_t c = in[i];
+        int val    = (0xff < c) ? -1 : dec_char(a, (uint8_t) c);
 
-        val = map[in[i]];
         if (val < 0) {
             return 0;
         }
@@ -270,11 +851,175 @@ static size_t decode(const int8_t *map, const uint8_t *in, size_t len, uint8_t *
     return j;
 }
 
-static uint8_t *decode_w_alloc(size_t(size_fn)(const size_t),
+static const struct alphabet *flags_alphabet(unsigned flags)
+{
+    if (B64_DECODE_ANY_ALPHABET & flags) {
+        return &b64_any;
+    }
+    if (B64_DECODE_URL & flags) {
+        return &b64_url;
+    }
+    return &b64_std;
+}
+
+#ifndef B64_KERNEL_TABLEFREE
+static inline uint8_t enc_char(const struct alphabet *a, unsigned val)
+{
+    return (uint8_t) a->enc[val];
+}
+
+/* Returns the value of the character, or a negative number if it is not part
+ * of the alphabet. */
+static inline int dec_char(const struct alphabet *a, uint8_t c)
+{
+    return a->dec[c];
+}
+#else
+/* The table free kernel translates with range compares done as arithmetic, so
+ * there are no branches on the data and the only memory it reads is the
+ * alphabet itself. */
+static inline uint8_t enc_char(const struct alphabet *a, unsigned val)
+{
+    unsigned c = val + 'A';
+
+    c += in_range((int) val, 26, 63) & ('a' - 26 - 'A');
+    c -= in_range((int) val, 52, 63) & (('a' - 26) - ('0' - 52));
+    c += in_range((int) val, 62, 63) & (unsigned) (a->c62[0] - ('0' - 52 + 62));
+    c += in_range((int) val, 63, 63) & (unsigned) (a->c63[0] - (a->c62[0] + 1));
+
+    return (uint8_t) c;
+}
+
+static inline int dec_char(const struct alphabet *a, uint8_t c)
+{
+    return ct_dec_char(a, c);
+}
+#endif
+
+/* Returns the value of the character, or -1 if it is not part of the
+ * alphabet, without branching on the character or reading a table.  This
+ * serves the table free kernel and constant time decoding in every build. */
+static inline int ct_dec_char(const struct alphabet *a, uint8_t c)
+{
+    unsigned upper = in_range(c, 'A', 'Z');
+    unsigned lower = in_range(c, 'a', 'z');
+    unsigned digit = in_range(c, '0', '9');
+    unsigned s62   = is_char(c, a->c62[0]);
+    unsigned s63   = is_char(c, a->c63[0]);
+    unsigned valid, val;
+
+    /* Only the mixed alphabet has second spellings. */
+    if ((a->c62[0] != a->c62[1]) || (a->c63[0] != a->c63[1])) {
+        s62 |= is_char(c, a->c62[1]);
+        s63 |= is_char(c, a->c63[1]);
+    }
+
+    valid = upper | lower | digit | s62 | s63;
+    val   = (upper & (c - 'A')) | (lower & (c - 'a' + 26)) | (digit & (c - '0' + 52))
+        | (s62 & 62) | (s63 & 63);
+
+    /* -1 if nothing matched */
+    return (int) (valid & val) - (int) (1 & ~valid);
+}
+
+/* The largest output the length allows under the padding rules, or 0 if no
+ * input of this length can be valid. */
+static size_t flags_decoded_size(size_t len, unsigned flags)
+{
+    size_t remainder = 0x03 & len;
+
+    if ((1 == remainder) || (remainder && (B64_DECODE_PAD_REQUIRED & flags))) {
+        return 0;
+    }
+    if (remainder) {
+        remainder--;
+    }
+
+    return (len / 4) * 3 + remainder;
+}
+
+/* Applies the same length and padding rules as decode() and decode_flags(),
+ * and checks the characters of the final group, without walking the rest. */
+static size_t exact_decoded_size(const struct alphabet *a, const uint8_t *enc, size_t len,
+                                 unsigned flags, int *needs_decode)
+{
+    size_t size    = flags_decoded_size(len, flags);
+    size_t padding = 0;
+    size_t last;
+
+    if (needs_decode) {
+        *needs_decode = 0;
+    }
+    if (!size || !enc) {
+        return 0;
+    }
+
+    if ('=' == enc[len - 1]) {
+        padding++;
+        if ('=' == enc[len - 2]) {
+            padding++;
+        }
+        if ((B64_DECODE_PAD_FORBIDDEN & flags) || (0 != (0x03 & len))) {
+            return 0;
+        }
+    }
+
+    /* Checking the final group early would leak which character is bad. */
+    if (B64_DECODE_CONSTANT_TIME & flags) {
+        if (needs_decode) {
+            *needs_decode = 1;
+        }
+        return size - padding;
+    }
+
+    last = (0x03 & len) ? len - (0x03 & len) : len - 4;
+    for (size_t i = last; i < len - padding; i++) {
+        if (dec_char(a, enc[i]) < 0) {
+            return 0;
+        }
+    }
+
+    if (needs_decode) {
+        *needs_decode = (0 < last);
+    }
+
+    return size - padding;
+}
+
+/* All of the length and padding rules are resolved here up front, so the
+ * characters are only ever walked once. */
+static size_t decode_flags(const uint8_t *enc, size_t len, uint8_t *out, unsigned flags)
+{
+    size_t padding = 0;
+
+    if (0 == flags_decoded_size(len, flags)) {
+        return 0;
+    }
+
+    if ('=' == enc[len - 1]) {
+        padding++;
+        if ('=' == enc[len - 2]) {
+            padding++;
+        }
+
+        /* Padding is only ever used to complete the final quantum. */
+        if ((B64_DECODE_PAD_FORBIDDEN & flags) || (0 != (0x03 & len))) {
+            return 0;
+        }
+    }
+
+    if (B64_DECODE_CONSTANT_TIME & flags) {
+        return decode_body_ct(flags_alphabet(flags), enc, len - padding, out);
+    }
+
+    return decode_body(flags_alphabet(flags), enc, len - padding, out);
+}
+
+static uint8_t *decode_w_alloc(size_t(size_fn)(const uint8_t *, size_t, int *),
                                size_t(decode_fn)(const uint8_t *, const size_t, uint8_t *),
                                const uint8_t *enc, size_t len, size_t *out_len)
 {
-    size_t raw_len = size_fn(len);
+    size_t raw_len = size_fn(enc, len, NULL);
     uint8_t *buf   = NULL;
 
     if (out_len) {
@@ -307,7 +1052,8 @@ static char *encode_w_alloc(size_t(size_fn)(const size_t),
         *out_len = 0;
     }
 
-    if (!enc_len || !raw) {
+    /* Longer input would wrap enc_len around. */
+    if (!enc_len || !raw || (B64_MAX_ENCODE_LEN < len)) {
         return NULL;
     }
 
@@ -322,3 +1068,224 @@ static char *encode_w_alloc(size_t(size_fn)(const size_t),
 
     return buf;
 }
+
+/* Decodes the text in one pass, resolving any JSON escapes as it goes.  Runs
+ * of unescaped text that start on a quantum boundary are decoded in place;
+ * only the few characters around each escape are staged in block[].  The end
+ * of the text is always handed to decode_fn() so the padding and length rules
+ * are exactly those of the non-JSON function. */
+static size_t decode_json(const struct alphabet *a,
+                          size_t(decode_fn)(const uint8_t *, const size_t, uint8_t *),
+                          const uint8_t *enc, size_t len, uint8_t *out)
+{
+    uint8_t block[JSON_BLOCK_SIZE];
+    const uint8_t *end = enc + len;
+    const uint8_t *p   = enc;
+    size_t n           = 0;
+    size_t j           = 0;
+    size_t rv;
+
+    if (!enc || !out) {
+        return 0;
+    }
+
+    /* The common case: nothing is escaped. */
+    if (!memchr(enc, '\\', len)) {
+        return decode_fn(enc, len, out);
+    }
+
+    while (p < end) {
+        const uint8_t *bs = memchr(p, '\\', (size_t) (end - p));
+        const uint8_t *seg_end = (bs) ? bs : end;
+        uint8_t c;
+
+        /* Top up the staged characters to a quantum boundary. */
+        while ((0x03 & n) && (p < seg_end)) {
+            block[n++] = *p++;
+        }
+
+        if (p < seg_end) {
+            size_t direct;
+
+            /* Padding is only valid at the very end of the text. */
+            if (n) {
+                if ('=' == block[n - 1]) {
+                    return 0;
+                }
+                rv = decode(a, block, n, &out[j]);
+                if (0 == rv) {
+                    return 0;
+                }
+                j += rv;
+                n = 0;
+            }
+
+            if (!bs) {
+                rv = decode_fn(p, (size_t) (end - p), &out[j]);
+                return (0 == rv) ? 0 : j + rv;
+            }
+
+            direct = ~(size_t) 0x03 & (size_t) (seg_end - p);
+            if (direct) {
+                if ('=' == p[direct - 1]) {
+                    return 0;
+                }
+                rv = decode(a, p, direct, &out[j]);
+                if (0 == rv) {
+                    return 0;
+                }
+                j += rv;
+                p += direct;
+            }
+
+            while (p < seg_end) {
+                block[n++] = *p++;
+            }
+        }
+
+        if (!bs) {
+            break;
+        }
+
+        rv = json_unescape(bs, (size_t) (end - bs), &c);
+        if (0 == rv) {
+            return 0;
+        }
+        p = bs + rv;
+
+        if (sizeof(block) == n) {
+            if ('=' == block[n - 1]) {
+                return 0;
+            }
+            rv = decode(a, block, n, &out[j]);
+            if (0 == rv) {
+                return 0;
+            }
+            j += rv;
+            n = 0;
+        }
+        block[n++] = c;
+    }
+
+    rv = decode_fn(block, n, &out[j]);
+
+    return (0 == rv) ? 0 : j + rv;
+}
+
+/* Resolves the JSON escape at the start of in.  Only escapes that produce
+ * 7-bit characters are accepted; anything else is rejected by the decode map.
+ * Returns the number of characters consumed, or 0 if the escape is invalid. */
+static size_t json_unescape(const uint8_t *in, size_t len, uint8_t *c)
+{
+    uint32_t val = 0;
+
+    if ((2 <= len) && ('/' == in[1])) {
+        *c = '/';
+        return 2;
+    }
+
+    if ((len < 6) || ('u' != in[1])) {
+        return 0;
+    }
+
+    for (size_t i = 2; i < 6; i++) {
+        uint8_t h = in[i];
+
+        if (('0' <= h) && (h <= '9')) {
+            h -= '0';
+        } else if (('a' <= (h | 0x20)) && ((h | 0x20) <= 'f')) {
+            h = (uint8_t) ((h | 0x20) - 'a' + 10);
+        } else {
+            return 0;
+        }
+        val = (val << 4) | h;
+    }
+
+    if (0x7f < val) {
+        return 0;
+    }
+    *c = (uint8_t) val;
+
+    return 6;
+}
+
+static size_t decode_append(size_t(size_fn)(const uint8_t *, size_t, int *),
+                            size_t(decode_fn)(const uint8_t *, const size_t, uint8_t *),
+                            b64_buf_t *dst, const uint8_t *enc, size_t len)
+{
+    size_t raw_len = dst ? size_fn(enc, len, NULL) : 0;
+    uint8_t *p     = NULL;
+
+    if (!raw_len) {
+        return 0;
+    }
+
+    p = b64_buf_reserve(dst, raw_len);
+    if (!p) {
+        return 0;
+    }
+
+    raw_len = decode_fn(enc, len, p);
+    dst->len += raw_len;
+
+    return raw_len;
+}
+
+static size_t encode_append(size_t(size_fn)(const size_t),
+                            void(encode_fn)(const uint8_t *, const size_t, uint8_t *),
+                            b64_buf_t *dst, const uint8_t *raw, size_t len)
+{
+    size_t enc_len = size_fn(len);
+    uint8_t *p     = NULL;
+
+    if (!enc_len || !raw || !dst || (B64_MAX_ENCODE_LEN < len)) {
+        return 0;
+    }
+
+    p = b64_buf_reserve(dst, enc_len);
+    if (!p) {
+        return 0;
+    }
+
+    encode_fn(raw, len, p);
+    dst->len += enc_len;
+
+    return enc_len;
+}
+
+/* Each chunk but the last is whole groups, so padding, which only ends the
+ * input, may only shorten the last one. */
+static size_t decode_chunked(const uint8_t *enc, size_t len, unsigned flags, b64_chunk_cb_t cb,
+                             void *user)
+{
+    uint8_t chunk[B64_DECODE_CHUNK_MAX];
+    size_t total = 0;
+    int failed   = 0;
+
+    if (0 == flags_decoded_size(len, flags)) {
+        return 0;
+    }
+
+    while (len) {
+        size_t n   = (CHUNK_SIZE < len) ? CHUNK_SIZE : len;
+        size_t got = decode_flags(enc, n, chunk, flags);
+
+        if ((0 == got) || ((n < len) && ((n / 4) * 3 != got))) {
+            /* Stopping here would tell a timing observer which chunk the bad
+             * character is in, so constant time decodes go on to the end,
+             * only without passing anything more to the callback. */
+            if (!(B64_DECODE_CONSTANT_TIME & flags)) {
+                return 0;
+            }
+            failed = 1;
+        } else if (!failed && (0 != cb(chunk, got, user))) {
+            return 0;
+        }
+
+        total += got;
+        enc += n;
+        len -= n;
+    }
+
+    return failed ? 0 : total;
+}
@@ -0,0 +1,410 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "base64.h"
+#include "cache.h"
+#include "internal.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                   Macros                                   */
+/*----------------------------------------------------------------------------*/
+#ifndef __GNUC__
+#error "The encode cache requires GCC or clang atomics."
+#endif
+
+/* Each of the first OWNED threads to use any cache gets a stripe of counters
+ * in every cache to itself, which it bumps with a plain load and store.  A
+ * locked add would cost about as much as the rest of a hit.  Threads past
+ * that share the last stripe, with atomic adds.  The slots of exited threads
+ * are handed to new ones. */
+#define OWNED      64
+#define SHARED     OWNED
+#define CACHE_LINE 64
+
+/* Keys up to this long are packed into one word, which the hash keeps
+ * intact, so equal hashes mean equal keys. */
+#define SHORT_KEY  8
+#define HASH_PRIME 0x9e3779b97f4a7c15ULL
+
+/*----------------------------------------------------------------------------*/
+/*                               Data Structures                              */
+/*----------------------------------------------------------------------------*/
+
+/* Entries are immutable once they are published in a slot. */
+struct entry {
+    uint64_t hash;
+    size_t len;     /* raw bytes */
+    size_t enc_len; /* encoded characters */
+    int url;
+    uint8_t data[]; /* the encoded string, '\0', then the raw bytes */
+};
+
+enum counter {
+    HITS = 0,
+    MISSES,
+    REJECTED,
+    COUNTERS
+};
+
+struct stripe {
+    uint64_t n[COUNTERS];
+    uint8_t pad[CACHE_LINE - COUNTERS * sizeof(uint64_t)];
+};
+
+struct b64_cache {
+    struct stripe stripes[OWNED + 1];
+
+    /* Open addressing with linear probing.  There are at least twice as many
+     * slots as entries, so a probe always reaches an empty slot. */
+    struct entry **slots;
+    size_t mask;
+    unsigned shift; /* keeps the top bits of a hash as its first slot */
+
+    size_t capacity;
+    size_t max_len;
+    size_t count; /* entries added or being added */
+};
+
+/*----------------------------------------------------------------------------*/
+/*                            File Scoped Variables                           */
+/*----------------------------------------------------------------------------*/
+static pthread_mutex_t slots_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned next_slot          = 0;
+static unsigned free_slots[OWNED];
+static size_t free_count = 0;
+
+static pthread_once_t key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t key;
+static int have_key = 0;
+
+static __thread unsigned thread_slot = 0; /* the stripe + 1, or 0 before first use */
+
+/*----------------------------------------------------------------------------*/
+/*                             Function Prototypes                            */
+/*----------------------------------------------------------------------------*/
+static const char *cache_encode(b64_cache_t *cache, int url, const uint8_t *raw, size_t len,
+                                size_t *out_len);
+static uint64_t hash_key(const uint8_t *raw, size_t len, int url);
+static uint64_t pack(const uint8_t *raw, size_t len);
+static int matches(const struct entry *e, uint64_t hash, int url, const uint8_t *raw,
+                   size_t len);
+static struct entry *entry_new(b64_cache_t *cache, uint64_t hash, int url, const uint8_t *raw,
+                               size_t len);
+static void entry_free(b64_cache_t *cache, struct entry *e);
+static unsigned slot_take(void);
+static void slot_give_back(void *slot);
+static void key_create(void);
+static void count(b64_cache_t *cache, enum counter c);
+
+/*----------------------------------------------------------------------------*/
+/*                             External Functions                             */
+/*----------------------------------------------------------------------------*/
+b64_cache_t *b64_cache_create(size_t capacity, size_t max_len)
+{
+    b64_cache_t *cache;
+    size_t slots = 1;
+
+    if (!capacity || !max_len || ((SIZE_MAX / 4) / sizeof(struct entry *) < capacity)
+        || (SIZE_MAX / 4 < max_len))
+    {
+        return NULL;
+    }
+
+    while (slots < 2 * capacity) {
+        slots <<= 1;
+    }
+
+    /* Line aligned, so no two stripes share a line. */
+    if (0 != posix_memalign((void **) &cache, CACHE_LINE, sizeof(b64_cache_t))) {
+        return NULL;
+    }
+    memset(cache, 0, sizeof(b64_cache_t));
+
+    cache->slots = calloc(slots, sizeof(struct entry *));
+    if (!cache->slots) {
+        free(cache);
+        return NULL;
+    }
+    cache->mask     = slots - 1;
+    cache->shift    = 64;
+    while (slots >>= 1) {
+        cache->shift--;
+    }
+    cache->capacity = capacity;
+    cache->max_len  = max_len;
+
+    return cache;
+}
+
+
+void b64_cache_destroy(b64_cache_t *cache)
+{
+    if (!cache) {
+        return;
+    }
+
+    for (size_t i = 0; i <= cache->mask; i++) {
+        free(cache->slots[i]);
+    }
+    free(cache->slots);
+    free(cache);
+}
+
+
+const char *b64_cache_encode(b64_cache_t *cache, const uint8_t *raw, size_t len,
+                             size_t *out_len)
+{
+    return cache_encode(cache, 0, raw, len, out_len);
+}
+
+
+const char *b64url_cache_encode(b64_cache_t *cache, const uint8_t *raw, size_t len,
+                                size_t *out_len)
+{
+    return cache_encode(cache, 1, raw, len, out_len);
+}
+
+
+void b64_cache_get_stats(const b64_cache_t *cache, b64_cache_stats_t *out)
+{
+    size_t n;
+
+    if (!out) {
+        return;
+    }
+
+    memset(out, 0, sizeof(*out));
+    if (!cache) {
+        return;
+    }
+
+    for (size_t i = 0; i <= SHARED; i++) {
+        out->hits += __atomic_load_n(&cache->stripes[i].n[HITS], __ATOMIC_RELAXED);
+        out->misses += __atomic_load_n(&cache->stripes[i].n[MISSES], __ATOMIC_RELAXED);
+        out->rejected += __atomic_load_n(&cache->stripes[i].n[REJECTED], __ATOMIC_RELAXED);
+    }
+
+    /* The count briefly runs ahead while a full cache turns an insert away. */
+    n             = __atomic_load_n(&cache->count, __ATOMIC_RELAXED);
+    out->entries  = (n < cache->capacity) ? n : cache->capacity;
+    out->capacity = cache->capacity;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                             Internal functions                             */
+/*----------------------------------------------------------------------------*/
+
+/* Finds the value, or encodes it and publishes it in the first empty slot of
+ * its probe sequence.  If another thread publishes the same value first, its
+ * entry is used and ours is thrown away, so every caller sees one pointer. */
+static const char *cache_encode(b64_cache_t *cache, int url, const uint8_t *raw, size_t len,
+                                size_t *out_len)
+{
+    struct entry *mine  = NULL;
+    struct entry *found = NULL;
+    uint64_t hash;
+
+    if (out_len) {
+        *out_len = 0;
+    }
+    if (!cache || !raw || !len || (cache->max_len < len)) {
+        return NULL;
+    }
+
+    hash = hash_key(raw, len, url);
+
+    for (size_t i = (size_t) (hash >> cache->shift); !found; i = (i + 1) & cache->mask) {
+        struct entry *e = __atomic_load_n(&cache->slots[i], __ATOMIC_ACQUIRE);
+
+        if (!e) {
+            if (!mine) {
+                mine = entry_new(cache, hash, url, raw, len);
+                if (!mine) {
+                    count(cache, MISSES);
+                    count(cache, REJECTED);
+                    return NULL;
+                }
+            }
+            if (__atomic_compare_exchange_n(&cache->slots[i], &e, mine, 0, __ATOMIC_RELEASE,
+                                            __ATOMIC_ACQUIRE))
+            {
+                count(cache, MISSES);
+                found = mine;
+                continue;
+            }
+            /* Lost the race; e is now the winner's entry. */
+        }
+
+        if (matches(e, hash, url, raw, len)) {
+            if (mine) {
+                entry_free(cache, mine);
+                count(cache, MISSES);
+            } else {
+                count(cache, HITS);
+            }
+            found = e;
+        }
+    }
+
+    if (out_len) {
+        *out_len = found->enc_len;
+    }
+    return (const char *) found->data;
+}
+
+/* Mixes the input a word at a time, with the length and alphabet folded into
+ * the seed so a short tail can't collide with leading zero bytes.  The last
+ * one to eight bytes are always packed into the final word.  That xor and
+ * multiply by an odd constant can be undone, so for a key of SHORT_KEY bytes
+ * or less the hash, length and alphabet together identify the key and no
+ * byte compare is needed.  Only the top bits pick the slot, and those already
+ * depend on every input bit, so no final avalanche is needed either.  The
+ * hash never leaves memory, so the byte order of the words is unimportant. */
+static uint64_t hash_key(const uint8_t *raw, size_t len, int url)
+{
+    uint64_t h = 0xcbf29ce484222325ULL ^ ((uint64_t) len << 1) ^ (uint64_t) url;
+    uint64_t w;
+    size_t i = 0;
+
+    for (; i + SHORT_KEY < len; i += 8) {
+        memcpy(&w, &raw[i], 8);
+        h = (h ^ w) * HASH_PRIME;
+        h ^= h >> 32;
+    }
+
+    return (h ^ pack(&raw[i], len - i)) * HASH_PRIME;
+}
+
+/* Packs 1 to 8 bytes into a word with at most two (maybe overlapping) loads
+ * rather than a byte at a time.  Every byte lands in the word, so for a given
+ * length no two inputs pack the same. */
+static uint64_t pack(const uint8_t *raw, size_t len)
+{
+    uint32_t lo, hi;
+
+    if (4 <= len) {
+        memcpy(&lo, raw, 4);
+        memcpy(&hi, &raw[len - 4], 4);
+        return ((uint64_t) hi << 32) | lo;
+    }
+    return ((uint64_t) raw[0] << 16) | ((uint64_t) raw[len / 2] << 8) | raw[len - 1];
+}
+
+static int matches(const struct entry *e, uint64_t hash, int url, const uint8_t *raw,
+                   size_t len)
+{
+    return (hash == e->hash) && (len == e->len) && (url == e->url)
+        && ((len <= SHORT_KEY) || (0 == memcmp(&e->data[e->enc_len + 1], raw, len)));
+}
+
+/* Reserves room in the cache and builds the entry, or returns NULL if the
+ * cache is full or out of memory. */
+static struct entry *entry_new(b64_cache_t *cache, uint64_t hash, int url, const uint8_t *raw,
+                               size_t len)
+{
+    size_t enc_len = url ? b64url_get_encoded_buffer_size(len) : b64_get_encoded_buffer_size(len);
+    struct entry *e;
+
+    /* Checking first keeps a full cache from bouncing the count's cache line
+     * between every thread that misses. */
+    if (cache->capacity <= __atomic_load_n(&cache->count, __ATOMIC_RELAXED)) {
+        return NULL;
+    }
+    if (cache->capacity <= __atomic_fetch_add(&cache->count, 1, __ATOMIC_RELAXED)) {
+        __atomic_fetch_sub(&cache->count, 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+
+    e = malloc(sizeof(struct entry) + enc_len + 1 + len);
+    if (!e) {
+        __atomic_fetch_sub(&cache->count, 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+
+    e->hash    = hash;
+    e->len     = len;
+    e->enc_len = enc_len;
+    e->url     = url;
+    if (url) {
+        b64_url_encode(raw, len, e->data);
+    } else {
+        b64_std_encode(raw, len, e->data);
+    }
+    e->data[enc_len] = '\0';
+    memcpy(&e->data[enc_len + 1], raw, len);
+
+    return e;
+}
+
+/* Frees an entry that was never published. */
+static void entry_free(b64_cache_t *cache, struct entry *e)
+{
+    free(e);
+    __atomic_fetch_sub(&cache->count, 1, __ATOMIC_RELAXED);
+}
+
+/* Gives the calling thread a stripe of its own if one is free, or the shared
+ * one. */
+static unsigned slot_take(void)
+{
+    unsigned slot = SHARED;
+
+    pthread_once(&key_once, key_create);
+
+    pthread_mutex_lock(&slots_lock);
+    if (have_key && free_count) {
+        slot = free_slots[--free_count];
+    } else if (have_key && (next_slot < OWNED)) {
+        slot = next_slot++;
+    }
+    pthread_mutex_unlock(&slots_lock);
+
+    /* The value is the slot + 1, since a NULL value gets no destructor call. */
+    if ((SHARED != slot) && (0 != pthread_setspecific(key, (void *) (uintptr_t) (slot + 1)))) {
+        slot_give_back((void *) (uintptr_t) (slot + 1));
+        slot = SHARED;
+    }
+
+    return slot;
+}
+
+/* The key destructor: the exited thread's stripes, with their counts, pass
+ * to the next new thread. */
+static void slot_give_back(void *slot)
+{
+    pthread_mutex_lock(&slots_lock);
+    free_slots[free_count++] = (unsigned) ((uintptr_t) slot - 1);
+    pthread_mutex_unlock(&slots_lock);
+}
+
+static void key_create(void)
+{
+    have_key = (0 == pthread_key_create(&key, slot_give_back));
+}
+
+static void count(b64_cache_t *cache, enum counter c)
+{
+    uint64_t *n;
+
+    if (!thread_slot) {
+        thread_slot = 1 + slot_take();
+    }
+    n = &cache->stripes[thread_slot - 1].n[c];
+
+    /* Readers only ever load the counter, so an owned one needs no locked
+     * add, only a store that can't tear. */
+    if (SHARED == thread_slot - 1) {
+        __atomic_fetch_add(n, 1, __ATOMIC_RELAXED);
+    } else {
+        __atomic_store_n(n, __atomic_load_n(n, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
+    }
+}
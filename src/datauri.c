@@ -0,0 +1,178 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "base64.h"
+#include "datauri.h"
+#include "internal.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                   Macros                                   */
+/*----------------------------------------------------------------------------*/
+#define SCHEME     "data:"
+#define SCHEME_LEN (sizeof(SCHEME) - 1)
+#define BASE64     ";base64"
+#define BASE64_LEN (sizeof(BASE64) - 1)
+
+/* "data:" ";base64" "," */
+#define HEADER_LEN (SCHEME_LEN + BASE64_LEN + 1)
+
+/* Producers don't agree on padding data: URIs, so accept either. */
+#define PAYLOAD_FLAGS (B64_DECODE_STANDARD | B64_DECODE_PAD_OPTIONAL)
+
+/*----------------------------------------------------------------------------*/
+/*                               Data Structures                              */
+/*----------------------------------------------------------------------------*/
+/* none */
+
+/*----------------------------------------------------------------------------*/
+/*                            File Scoped Variables                           */
+/*----------------------------------------------------------------------------*/
+/* none */
+
+/*----------------------------------------------------------------------------*/
+/*                             Function Prototypes                            */
+/*----------------------------------------------------------------------------*/
+static int matches(const char *s, const char *lower, size_t len);
+
+/*----------------------------------------------------------------------------*/
+/*                             External Functions                             */
+/*----------------------------------------------------------------------------*/
+size_t b64_data_uri_parse(const char *uri, size_t len, b64_data_uri_t *out)
+{
+    const char *comma;
+    size_t header;
+
+    if (out) {
+        memset(out, 0, sizeof(*out));
+    }
+    if (!uri || !out || (len < HEADER_LEN) || !matches(uri, SCHEME, SCHEME_LEN)) {
+        return 0;
+    }
+
+    /* The media type can't contain a ',', so the first one ends the header. */
+    comma = memchr(&uri[SCHEME_LEN], ',', len - SCHEME_LEN);
+    if (!comma) {
+        return 0;
+    }
+    header = comma - uri;
+
+    if ((header < SCHEME_LEN + BASE64_LEN) || (len - 1 == header)
+        || !matches(&uri[header - BASE64_LEN], BASE64, BASE64_LEN))
+    {
+        return 0;
+    }
+
+    out->mime_len    = header - BASE64_LEN - SCHEME_LEN;
+    out->mime        = out->mime_len ? &uri[SCHEME_LEN] : NULL;
+    out->payload     = comma + 1;
+    out->payload_len = len - header - 1;
+
+    return b64_get_decoded_size_flags((const uint8_t *) out->payload, out->payload_len,
+                                      PAYLOAD_FLAGS, NULL);
+}
+
+
+size_t b64_data_uri_decode(const b64_data_uri_t *uri, uint8_t *out)
+{
+    if (!uri || !uri->payload || !uri->payload_len || !out) {
+        return 0;
+    }
+
+    /* Each 4 character group is read before its 3 bytes are written, and the
+     * bytes never land past the group, so out may be the payload itself. */
+    return b64_flags_decode((const uint8_t *) uri->payload, uri->payload_len, out, PAYLOAD_FLAGS);
+}
+
+
+size_t b64_data_uri_get_encoded_size(size_t mime_len, size_t len)
+{
+    size_t enc_len = b64_get_encoded_buffer_size_checked(len, NULL);
+
+    if (!enc_len || (SIZE_MAX - HEADER_LEN - enc_len < mime_len)) {
+        return 0;
+    }
+
+    return HEADER_LEN + mime_len + enc_len;
+}
+
+
+size_t b64_data_uri_encode(const char *mime, size_t mime_len, const uint8_t *raw, size_t len,
+                           char *out)
+{
+    size_t size = b64_data_uri_get_encoded_size(mime_len, len);
+    char *p     = out;
+
+    if (!size || !raw || !out || (mime_len && !mime) || (mime_len && memchr(mime, ',', mime_len))) {
+        return 0;
+    }
+
+    memcpy(p, SCHEME, SCHEME_LEN);
+    p += SCHEME_LEN;
+    if (mime_len) {
+        memcpy(p, mime, mime_len);
+        p += mime_len;
+    }
+    memcpy(p, BASE64 ",", BASE64_LEN + 1);
+    p += BASE64_LEN + 1;
+
+    b64_std_encode(raw, len, (uint8_t *) p);
+
+    return size;
+}
+
+
+char *b64_data_uri_encode_with_alloc(const char *mime, size_t mime_len, const uint8_t *raw,
+                                     size_t len, size_t *out_len)
+{
+    size_t size = b64_data_uri_get_encoded_size(mime_len, len);
+    char *buf   = NULL;
+
+    if (out_len) {
+        *out_len = 0;
+    }
+    if (!size || (SIZE_MAX == size)) {
+        return NULL;
+    }
+
+    buf = malloc(size + 1);
+    if (buf) {
+        if (size != b64_data_uri_encode(mime, mime_len, raw, len, buf)) {
+            free(buf);
+            return NULL;
+        }
+        buf[size] = '\0';
+        if (out_len) {
+            *out_len = size;
+        }
+    }
+
+    return buf;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                             Internal functions                             */
+/*----------------------------------------------------------------------------*/
+
+/* Compares len characters of s with the lower case ASCII in lower, ignoring
+ * the case of s. */
+static int matches(const char *s, const char *lower, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        char c = s[i];
+
+        if (('A' <= c) && (c <= 'Z')) {
+            c = (char) (c - 'A' + 'a');
+        }
+        if (c != lower[i]) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
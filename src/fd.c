@@ -0,0 +1,616 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "base64.h"
+#include "fd.h"
+#include "internal.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                   Macros                                   */
+/*----------------------------------------------------------------------------*/
+
+/* The most read from the input at a time.  192 KiB is a multiple of both 3
+ * and 4, covers a full pipe (64 KiB) several times over and keeps the
+ * syscall cost per byte well under the cost of the codec. */
+#define BLOCK_SIZE (192 * 1024)
+
+/* Room for the output of one block and of the group carried into it. */
+#define OUT_SIZE ((BLOCK_SIZE / 3 + 2) * 4)
+
+/* Output is gathered until there is at least this much to write, so a pipe
+ * or socket that hands over a few KiB per read doesn't cost a write(2) for
+ * each of them. */
+#define FLUSH_SIZE (64 * 1024)
+
+/* Buffers start on a page so the kernel can copy them a page at a time. */
+#define ALIGNMENT 4096
+
+/*----------------------------------------------------------------------------*/
+/*                               Data Structures                              */
+/*----------------------------------------------------------------------------*/
+struct slot {
+    uint8_t *data;
+    size_t len;
+    int full; /* read, but not yet consumed */
+};
+
+/* The reader fills slot 0, 1, 0, ... and the stream consumes them in the
+ * same order, so one is read while the other is encoded and written. */
+struct reader {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    pthread_t thread;
+    struct slot slot[2];
+    int fd;
+    int done;  /* no more slots will be filled */
+    int stop;  /* the stream has given up */
+    int error; /* the errno of a failed read, or 0 */
+};
+
+/* The two input blocks and the output block, in one page aligned
+ * allocation.  Each thread keeps its own from call to call. */
+struct buffers {
+    uint8_t *in[2];
+    uint8_t *out;
+};
+
+struct stream {
+    int fd;
+    unsigned flags;
+    uint8_t *out;
+    size_t used; /* output not yet written */
+
+    /* The start of a group that was split between reads. */
+    uint8_t carry[4];
+    size_t carried;
+
+    int ended; /* decode: the padding has been seen */
+};
+
+/*----------------------------------------------------------------------------*/
+/*                            File Scoped Variables                           */
+/*----------------------------------------------------------------------------*/
+static pthread_once_t key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t key;
+static int have_key = 0;
+
+static __thread struct buffers *thread_buffers = NULL;
+
+/*----------------------------------------------------------------------------*/
+/*                             Function Prototypes                            */
+/*----------------------------------------------------------------------------*/
+static int run(int in_fd, int out_fd, unsigned flags,
+               int (*block_fn)(struct stream *, uint8_t *, size_t),
+               int (*finish_fn)(struct stream *));
+static int run_sync(int in_fd, struct stream *s, uint8_t *in,
+                    int (*block_fn)(struct stream *, uint8_t *, size_t));
+static int run_reader(int in_fd, struct stream *s, struct buffers *b,
+                      int (*block_fn)(struct stream *, uint8_t *, size_t));
+static int is_file(int fd);
+static int encode_block(struct stream *s, uint8_t *in, size_t len);
+static int encode_finish(struct stream *s);
+static int decode_block(struct stream *s, uint8_t *in, size_t len);
+static int decode_groups(struct stream *s, const uint8_t *in, size_t len);
+static int decode_finish(struct stream *s);
+static size_t strip_newlines(uint8_t *p, size_t len);
+static size_t fill_carry(struct stream *s, size_t group, const uint8_t *in, size_t len);
+static int make_room(struct stream *s, size_t need);
+static int flush(struct stream *s);
+static int write_all(int fd, const uint8_t *p, size_t len);
+static struct buffers *buffers_get(void);
+static void buffers_put(struct buffers *b);
+static void buffers_free(void *b);
+static void key_create(void);
+static void reader_start(struct reader *r, int fd, uint8_t *data0, uint8_t *data1);
+static struct slot *reader_take(struct reader *r, int i);
+static void reader_release(struct reader *r, int i);
+static int reader_stop(struct reader *r, int cancel);
+static void *reader_main(void *arg);
+
+/*----------------------------------------------------------------------------*/
+/*                             External Functions                             */
+/*----------------------------------------------------------------------------*/
+int b64_encode_fd(int in_fd, int out_fd, unsigned flags)
+{
+    return run(in_fd, out_fd, flags, encode_block, encode_finish);
+}
+
+
+int b64_decode_fd(int in_fd, int out_fd, unsigned flags)
+{
+    return run(in_fd, out_fd, flags, decode_block, decode_finish);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                             Internal functions                             */
+/*----------------------------------------------------------------------------*/
+
+static int run(int in_fd, int out_fd, unsigned flags,
+               int (*block_fn)(struct stream *, uint8_t *, size_t),
+               int (*finish_fn)(struct stream *))
+{
+    struct stream s = { .fd = out_fd, .flags = flags };
+    struct buffers *b;
+    int err;
+
+    if ((in_fd < 0) || (out_fd < 0)) {
+        errno = EBADF;
+        return -1;
+    }
+
+    b = buffers_get();
+    if (!b) {
+        return -1;
+    }
+    s.out = b->out;
+
+    /* A regular file is read as fast as it can be translated, so a reader
+     * thread would only add its start up and hand offs.  Pipes and sockets
+     * block, and reading them ahead overlaps the waiting with the work. */
+    if (is_file(in_fd)) {
+        err = run_sync(in_fd, &s, b->in[0], block_fn);
+    } else {
+        err = run_reader(in_fd, &s, b, block_fn);
+    }
+
+    if (!err && (0 != finish_fn(&s))) {
+        err = errno;
+    }
+
+    /* What was decoded before invalid input is still written. */
+    if ((!err || (EINVAL == err)) && (0 != flush(&s)) && !err) {
+        err = errno;
+    }
+
+    buffers_put(b);
+
+    if (err) {
+        errno = err;
+        return -1;
+    }
+    return 0;
+}
+
+/* Returns 0, or the errno of the failure. */
+static int run_sync(int in_fd, struct stream *s, uint8_t *in,
+                    int (*block_fn)(struct stream *, uint8_t *, size_t))
+{
+    while (1) {
+        ssize_t n = read(in_fd, in, BLOCK_SIZE);
+
+        if (n < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return errno;
+        }
+        if (0 == n) {
+            return 0;
+        }
+        if (0 != block_fn(s, in, (size_t) n)) {
+            return errno;
+        }
+    }
+}
+
+/* Returns 0, or the errno of the failure. */
+static int run_reader(int in_fd, struct stream *s, struct buffers *b,
+                      int (*block_fn)(struct stream *, uint8_t *, size_t))
+{
+    struct reader r;
+    int err = 0;
+    int rv;
+
+    reader_start(&r, in_fd, b->in[0], b->in[1]);
+    rv = pthread_create(&r.thread, NULL, reader_main, &r);
+    if (0 != rv) {
+        pthread_cond_destroy(&r.cond);
+        pthread_mutex_destroy(&r.lock);
+        return rv;
+    }
+
+    for (int i = 0; 1; i ^= 1) {
+        struct slot *slot = reader_take(&r, i);
+
+        if (!slot) {
+            break;
+        }
+        if (0 != block_fn(s, slot->data, slot->len)) {
+            err = errno;
+            break;
+        }
+        reader_release(&r, i);
+    }
+
+    rv = reader_stop(&r, 0 != err);
+    return err ? err : rv;
+}
+
+static int is_file(int fd)
+{
+    struct stat st;
+
+    return (0 == fstat(fd, &st)) && (S_ISREG(st.st_mode) || S_ISBLK(st.st_mode));
+}
+
+static int encode_block(struct stream *s, uint8_t *in, size_t len)
+{
+    void (*encode_fn)(const uint8_t *, const size_t, uint8_t *) = b64_std_encode;
+    size_t whole, k;
+    uint8_t *out;
+
+    if (B64_ENCODE_URL & s->flags) {
+        encode_fn = b64_url_encode;
+    }
+    if (0 != make_room(s, (len / 3 + 2) * 4)) {
+        return -1;
+    }
+    out = &s->out[s->used];
+
+    /* Whole groups never pad, so both alphabets produce 4 characters. */
+    if (s->carried) {
+        k = fill_carry(s, 3, in, len);
+        in += k;
+        len -= k;
+        if (3 > s->carried) {
+            return 0;
+        }
+        encode_fn(s->carry, 3, out);
+        s->carried = 0;
+        s->used += 4;
+        out += 4;
+    }
+
+    whole = len - (len % 3);
+    if (whole) {
+        encode_fn(in, whole, out);
+        s->used += (whole / 3) * 4;
+    }
+    fill_carry(s, 3, &in[whole], len - whole);
+
+    return (FLUSH_SIZE <= s->used) ? flush(s) : 0;
+}
+
+static int encode_finish(struct stream *s)
+{
+    if (!s->carried) {
+        return 0;
+    }
+    if (0 != make_room(s, 4)) {
+        return -1;
+    }
+
+    if (B64_ENCODE_URL & s->flags) {
+        b64_url_encode(s->carry, s->carried, &s->out[s->used]);
+        s->used += b64url_get_encoded_buffer_size(s->carried);
+    } else {
+        b64_std_encode(s->carry, s->carried, &s->out[s->used]);
+        s->used += b64_get_encoded_buffer_size(s->carried);
+    }
+
+    return 0;
+}
+
+static int decode_block(struct stream *s, uint8_t *in, size_t len)
+{
+    size_t whole, k;
+
+    len = strip_newlines(in, len);
+    if (0 != make_room(s, len + 3)) {
+        return -1;
+    }
+
+    if (s->carried) {
+        k = fill_carry(s, 4, in, len);
+        in += k;
+        len -= k;
+        if (4 > s->carried) {
+            return 0;
+        }
+        s->carried = 0;
+        if (0 != decode_groups(s, s->carry, 4)) {
+            return -1;
+        }
+    }
+
+    whole = len & ~(size_t) 3;
+    if (whole && (0 != decode_groups(s, in, whole))) {
+        return -1;
+    }
+    fill_carry(s, 4, &in[whole], len - whole);
+
+    return (FLUSH_SIZE <= s->used) ? flush(s) : 0;
+}
+
+/* Decodes whole groups onto the output.  Padding ends a group short, after
+ * which nothing else may follow. */
+static int decode_groups(struct stream *s, const uint8_t *in, size_t len)
+{
+    size_t rv = 0;
+
+    if (!s->ended) {
+        rv = b64_flags_decode(in, len, &s->out[s->used], s->flags);
+    }
+    if (0 == rv) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if ((len / 4) * 3 != rv) {
+        s->ended = 1;
+    }
+    s->used += rv;
+
+    return 0;
+}
+
+/* The last 2 or 3 characters only decode if the flags allow leaving out the
+ * padding. */
+static int decode_finish(struct stream *s)
+{
+    size_t rv = 0;
+
+    if (!s->carried) {
+        return 0;
+    }
+    if (0 != make_room(s, 3)) {
+        return -1;
+    }
+
+    if (!s->ended) {
+        rv = b64_flags_decode(s->carry, s->carried, &s->out[s->used], s->flags);
+    }
+    if (0 == rv) {
+        errno = EINVAL;
+        return -1;
+    }
+    s->used += rv;
+
+    return 0;
+}
+
+/* Drops the CR and LF characters of line wrapped text (MIME, PEM bodies, the
+ * output of base64 -w) in place and returns the length left.  Text without
+ * any is only scanned. */
+static size_t strip_newlines(uint8_t *p, size_t len)
+{
+    uint8_t *cr = memchr(p, '\r', len);
+    uint8_t *lf = memchr(p, '\n', len);
+    size_t n;
+
+    if (!cr && !lf) {
+        return len;
+    }
+    n = (cr && (!lf || (cr < lf))) ? (size_t) (cr - p) : (size_t) (lf - p);
+
+    for (size_t i = n; i < len; i++) {
+        uint8_t c = p[i];
+
+        p[n] = c;
+        n += ('\r' != c) & ('\n' != c);
+    }
+
+    return n;
+}
+
+/* Adds up to a group's worth of input to the carry and returns how much was
+ * taken. */
+static size_t fill_carry(struct stream *s, size_t group, const uint8_t *in, size_t len)
+{
+    size_t k = group - s->carried;
+
+    if (len < k) {
+        k = len;
+    }
+    memcpy(&s->carry[s->carried], in, k);
+    s->carried += k;
+
+    return k;
+}
+
+/* Writes out what has been gathered if need more bytes would not fit. */
+static int make_room(struct stream *s, size_t need)
+{
+    return (OUT_SIZE - s->used < need) ? flush(s) : 0;
+}
+
+static int flush(struct stream *s)
+{
+    int rv = write_all(s->fd, s->out, s->used);
+
+    s->used = 0;
+    return rv;
+}
+
+static int write_all(int fd, const uint8_t *p, size_t len)
+{
+    while (len) {
+        ssize_t n = write(fd, p, len);
+
+        if (n < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return -1;
+        }
+        p += n;
+        len -= (size_t) n;
+    }
+
+    return 0;
+}
+
+/* Returns the calling thread's buffers, allocating them on its first call.
+ * They are freed when the thread exits.  If that can't be arranged they are
+ * only lent for one call. */
+static struct buffers *buffers_get(void)
+{
+    struct buffers *b = thread_buffers;
+    void *data        = NULL;
+    int rv;
+
+    if (b) {
+        return b;
+    }
+
+    b = malloc(sizeof(struct buffers));
+    if (!b) {
+        return NULL;
+    }
+    rv = posix_memalign(&data, ALIGNMENT, 2 * BLOCK_SIZE + OUT_SIZE);
+    if (0 != rv) {
+        free(b);
+        errno = rv;
+        return NULL;
+    }
+    b->in[0] = data;
+    b->in[1] = &b->in[0][BLOCK_SIZE];
+    b->out   = &b->in[0][2 * BLOCK_SIZE];
+
+    pthread_once(&key_once, key_create);
+    if (have_key && (0 == pthread_setspecific(key, b))) {
+        thread_buffers = b;
+    }
+
+    return b;
+}
+
+static void buffers_put(struct buffers *b)
+{
+    if (b != thread_buffers) {
+        buffers_free(b);
+    }
+}
+
+static void buffers_free(void *b)
+{
+    struct buffers *buffers = b;
+
+    free(buffers->in[0]);
+    free(buffers);
+}
+
+static void key_create(void)
+{
+    have_key = (0 == pthread_key_create(&key, buffers_free));
+}
+
+static void reader_start(struct reader *r, int fd, uint8_t *data0, uint8_t *data1)
+{
+    memset(r, 0, sizeof(*r));
+    r->fd           = fd;
+    r->slot[0].data = data0;
+    r->slot[1].data = data1;
+
+    pthread_mutex_init(&r->lock, NULL);
+    pthread_cond_init(&r->cond, NULL);
+}
+
+/* Waits for slot i to be filled.  Returns NULL once the input is exhausted. */
+static struct slot *reader_take(struct reader *r, int i)
+{
+    struct slot *rv = NULL;
+
+    pthread_mutex_lock(&r->lock);
+    while (!r->slot[i].full && !r->done) {
+        pthread_cond_wait(&r->cond, &r->lock);
+    }
+    if (r->slot[i].full) {
+        rv = &r->slot[i];
+    }
+    pthread_mutex_unlock(&r->lock);
+
+    return rv;
+}
+
+static void reader_release(struct reader *r, int i)
+{
+    pthread_mutex_lock(&r->lock);
+    r->slot[i].full = 0;
+    pthread_cond_broadcast(&r->cond);
+    pthread_mutex_unlock(&r->lock);
+}
+
+/* Joins the reader and returns the errno of a failed read, or 0.  When the
+ * stream gives up early the reader may be blocked reading a pipe or socket
+ * that has nothing more to say, so it is cancelled. */
+static int reader_stop(struct reader *r, int cancel)
+{
+    int rv;
+
+    if (cancel) {
+        pthread_mutex_lock(&r->lock);
+        r->stop = 1;
+        pthread_cond_broadcast(&r->cond);
+        pthread_mutex_unlock(&r->lock);
+        pthread_cancel(r->thread);
+    }
+    pthread_join(r->thread, NULL);
+
+    rv = r->error;
+    pthread_cond_destroy(&r->cond);
+    pthread_mutex_destroy(&r->lock);
+
+    return rv;
+}
+
+/* Cancellation is only allowed while the reader is blocked in read(2), where
+ * it holds no lock. */
+static void *reader_main(void *arg)
+{
+    struct reader *r = arg;
+    int state;
+
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &state);
+
+    for (int i = 0; 1; i ^= 1) {
+        ssize_t n;
+        int err;
+
+        pthread_mutex_lock(&r->lock);
+        while (r->slot[i].full && !r->stop) {
+            pthread_cond_wait(&r->cond, &r->lock);
+        }
+        if (r->stop) {
+            pthread_mutex_unlock(&r->lock);
+            break;
+        }
+        pthread_mutex_unlock(&r->lock);
+
+        do {
+            pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, &state);
+            n   = read(r->fd, r->slot[i].data, BLOCK_SIZE);
+            err = errno;
+            pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &state);
+        } while ((n < 0) && (EINTR == err));
+
+        pthread_mutex_lock(&r->lock);
+        if (0 < n) {
+            r->slot[i].len  = (size_t) n;
+            r->slot[i].full = 1;
+        } else {
+            r->error = (n < 0) ? err : 0;
+            r->done  = 1;
+        }
+        pthread_cond_broadcast(&r->cond);
+        pthread_mutex_unlock(&r->lock);
+
+        if (n <= 0) {
+            break;
+        }
+    }
+
+    return NULL;
+}
@@ -0,0 +1,206 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+#ifndef __BASE64_INTERNAL__
+#define __BASE64_INTERNAL__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base64.h"
+#include "stats.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                   Macros                                   */
+/*----------------------------------------------------------------------------*/
+
+/* The kernel that serves the codec calls in this build. */
+#if defined(B64_KERNEL_SWAR)
+#define STATS_KERNEL B64_STATS_KERNEL_SWAR
+#elif defined(B64_KERNEL_TABLEFREE)
+#define STATS_KERNEL B64_STATS_KERNEL_TABLEFREE
+#else
+#define STATS_KERNEL B64_STATS_KERNEL_SCALAR
+#endif
+
+/* Records one call to a public function.  This compiles away completely
+ * unless the library is built with the 'stats' option. */
+#ifdef B64_STATS
+#define STATS_RECORD_KERNEL(fn, kernel, len, ok) b64_stats_record((fn), (kernel), (len), (ok))
+#else
+#define STATS_RECORD_KERNEL(fn, kernel, len, ok) \
+    do {                                         \
+    } while (0)
+#endif
+
+/* The same, for the calls the build's kernel serves. */
+#define STATS_RECORD(fn, len, ok) STATS_RECORD_KERNEL((fn), STATS_KERNEL, (len), (ok))
+
+/* The functions below are shared between the library's sources but are not
+ * part of its API, so they are kept out of the shared library's exports. */
+#if defined(__GNUC__) && !defined(_WIN32)
+#define B64_INTERNAL __attribute__((visibility("hidden")))
+#else
+#define B64_INTERNAL
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*                             Function Prototypes                            */
+/*----------------------------------------------------------------------------*/
+
+/**
+ *  Encodes as many whole 6 byte blocks of in as fit in len, 64 bits at a
+ *  time.  Characters 62 and 63 of the alphabet are passed in; the rest are
+ *  always A-Z, a-z, 0-9.
+ *
+ *  @param in  the raw bytes
+ *  @param len the number of raw bytes
+ *  @param out where to write 8 characters for each block
+ *  @param c62 the character for 62
+ *  @param c63 the character for 63
+ *
+ *  @return the number of raw bytes consumed, always a multiple of 6
+ */
+B64_INTERNAL size_t b64_swar_encode(const uint8_t *in, size_t len, uint8_t *out, uint8_t c62,
+                                    uint8_t c63);
+
+/**
+ *  Decodes as many whole 8 character blocks of in as fit in len, stopping in
+ *  front of the first block that holds a character outside the alphabet
+ *  (including padding).  Either entry of c62/c63 is accepted.
+ *
+ *  @param in  the encoded characters
+ *  @param len the number of characters
+ *  @param out where to write 6 bytes for each block
+ *  @param c62 the characters for 62
+ *  @param c63 the characters for 63
+ *
+ *  @return the number of characters consumed, always a multiple of 8
+ */
+B64_INTERNAL size_t b64_swar_decode(const uint8_t *in, size_t len, uint8_t *out,
+                                    const uint8_t c62[2], const uint8_t c63[2]);
+
+/**
+ *  Encodes as many whole 4 byte blocks of in as fit in len into lower case
+ *  hex, 64 bits at a time.
+ *
+ *  @param in  the raw bytes
+ *  @param len the number of raw bytes
+ *  @param out where to write 8 characters for each block
+ *
+ *  @return the number of raw bytes consumed, always a multiple of 4
+ */
+B64_INTERNAL size_t b16_swar_encode(const uint8_t *in, size_t len, uint8_t *out);
+
+/**
+ *  Decodes as many whole 8 character blocks of hex (of either case) as fit in
+ *  len, stopping in front of the first block that holds anything else.
+ *
+ *  @param in  the encoded characters
+ *  @param len the number of characters
+ *  @param out where to write 4 bytes for each block
+ *
+ *  @return the number of characters consumed, always a multiple of 8
+ */
+B64_INTERNAL size_t b16_swar_decode(const uint8_t *in, size_t len, uint8_t *out);
+
+/**
+ *  Encodes as many whole 5 byte blocks of in as fit in len into base32, or
+ *  base32hex if hex is set, 64 bits at a time.
+ *
+ *  @param in  the raw bytes
+ *  @param len the number of raw bytes
+ *  @param out where to write 8 characters for each block
+ *  @param hex 1 for the base32hex alphabet
+ *
+ *  @return the number of raw bytes consumed, always a multiple of 5
+ */
+B64_INTERNAL size_t b32_swar_encode(const uint8_t *in, size_t len, uint8_t *out, int hex);
+
+/**
+ *  Decodes as many whole 8 character blocks as fit in len, stopping in front
+ *  of the first block that holds a character outside the alphabet (including
+ *  padding).  Letters of either case are accepted.
+ *
+ *  @param in  the encoded characters
+ *  @param len the number of characters
+ *  @param out where to write 5 bytes for each block
+ *  @param hex 1 for the base32hex alphabet
+ *
+ *  @return the number of characters consumed, always a multiple of 8
+ */
+B64_INTERNAL size_t b32_swar_decode(const uint8_t *in, size_t len, uint8_t *out, int hex);
+
+/**
+ *  Makes room for need more bytes at the end of the buffer, growing it
+ *  geometrically.  This is shared by every family's *_append() functions.
+ *
+ *  @param buf  the buffer
+ *  @param need the number of bytes that will be appended
+ *
+ *  @return where the bytes go, or NULL if the buffer couldn't grow
+ */
+B64_INTERNAL uint8_t *b64_buf_reserve(b64_buf_t *buf, size_t need);
+
+/* The bodies of b64_encode(), b64url_encode(), b64_decode() and
+ * b64_decode_flags() without the statistics, for the library's own callers,
+ * so a public call is counted once under its own name and never again under
+ * the codec function it is built on. */
+B64_INTERNAL void b64_std_encode(const uint8_t *raw, size_t len, uint8_t *out);
+B64_INTERNAL void b64_url_encode(const uint8_t *raw, size_t len, uint8_t *out);
+B64_INTERNAL size_t b64_std_decode(const uint8_t *enc, size_t len, uint8_t *out);
+B64_INTERNAL size_t b64_flags_decode(const uint8_t *enc, size_t len, uint8_t *out,
+                                     unsigned flags);
+
+/**
+ *  Translates unpadded characters of the standard alphabet, for callers that
+ *  have already checked the length and stripped the padding.  out may be in
+ *  itself, as every group is read before its bytes are written.
+ *
+ *  @param enc the characters, without padding
+ *  @param len the number of characters
+ *  @param out where to write the bytes
+ *
+ *  @return the number of bytes written, or 0 on any character outside the
+ *          alphabet (including '=') or if len is 0
+ */
+B64_INTERNAL size_t b64_std_decode_body(const uint8_t *enc, size_t len, uint8_t *out);
+
+#ifdef B64_STATS
+B64_INTERNAL void b64_stats_record(enum b64_stats_fn fn, enum b64_stats_kernel kernel, size_t len,
+                                   int ok);
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*                              Inline Functions                              */
+/*----------------------------------------------------------------------------*/
+
+/* The branch free compares that the arithmetic (table free and constant
+ * time) translations are built on. */
+
+/* All ones if lo <= x <= hi, otherwise 0. */
+static inline unsigned in_range(int x, int lo, int hi)
+{
+    return (((unsigned) (x - lo) | (unsigned) (hi - x)) >> 31) - 1;
+}
+
+/* All ones if c == k, otherwise 0. */
+static inline unsigned is_char(uint8_t c, uint8_t k)
+{
+    return 0u - (((unsigned) (c ^ k) - 1) >> 31);
+}
+
+/* The body of the *_get_encoded_buffer_size_checked() functions.  max is the
+ * longest input whose encoded size, plus a '\0', fits in a size_t. */
+static inline size_t checked_size(size_t(size_fn)(const size_t), size_t len, size_t max,
+                                  int *overflow)
+{
+    int over = (max < len);
+
+    if (overflow) {
+        *overflow = over;
+    }
+
+    return over ? 0 : size_fn(len);
+}
+
+#endif /* __BASE64_INTERNAL__ */
@@ -0,0 +1,260 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "base64.h"
+#include "internal.h"
+#include "pem.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                   Macros                                   */
+/*----------------------------------------------------------------------------*/
+#define BEGIN      "-----BEGIN "
+#define BEGIN_LEN  (sizeof(BEGIN) - 1)
+#define END        "-----END "
+#define END_LEN    (sizeof(END) - 1)
+#define DASHES     "-----"
+#define DASHES_LEN (sizeof(DASHES) - 1)
+
+/*----------------------------------------------------------------------------*/
+/*                               Data Structures                              */
+/*----------------------------------------------------------------------------*/
+/* none */
+
+/*----------------------------------------------------------------------------*/
+/*                            File Scoped Variables                           */
+/*----------------------------------------------------------------------------*/
+/* none */
+
+/*----------------------------------------------------------------------------*/
+/*                             Function Prototypes                            */
+/*----------------------------------------------------------------------------*/
+static const uint8_t *find(const uint8_t *p, const uint8_t *end, const char *s, size_t n);
+static const uint8_t *line_end(const uint8_t *p, const uint8_t *end);
+static size_t trim(const uint8_t *p, size_t n);
+static size_t body_decode(uint8_t *body, size_t n);
+static int add_entry(b64_pem_t *pem, size_t *size, const char *label, const uint8_t *der,
+                     size_t der_len);
+
+/*----------------------------------------------------------------------------*/
+/*                             External Functions                             */
+/*----------------------------------------------------------------------------*/
+size_t b64_pem_decode(const uint8_t *pem, size_t len, b64_pem_t *out)
+{
+    const uint8_t *p = pem;
+    b64_pem_t rv     = { 0 };
+    size_t size      = 0;
+    const uint8_t *end;
+    uint8_t *next;
+    uint8_t *arena;
+
+    if (!out) {
+        return 0;
+    }
+    memset(out, 0, sizeof(*out));
+
+    if (!pem || !len) {
+        return 0;
+    }
+    end = pem + len;
+
+    /* Each label and its '\0' fit in the "-----BEGIN " that precedes it, and
+     * each body decodes to 3/4 of its size, so the arena never needs to be
+     * larger than the bundle. */
+    rv.arena = malloc(len);
+    if (!rv.arena) {
+        return 0;
+    }
+    next = rv.arena;
+
+    while (NULL != (p = find(p, end, BEGIN, BEGIN_LEN))) {
+        const uint8_t *label = p + BEGIN_LEN;
+        const uint8_t *eol   = line_end(label, end);
+        const uint8_t *dash  = find(label, eol, DASHES, DASHES_LEN);
+        size_t body_len      = 0;
+        size_t label_len;
+        uint8_t *body;
+        char *name;
+
+        /* A '\0' would cut the label short, and the entries are rebuilt from
+         * the label lengths below. */
+        if (!dash || (dash == label) || memchr(label, '\0', dash - label)
+            || (0 != trim(dash + DASHES_LEN, eol - dash - DASHES_LEN)))
+        {
+            goto fail;
+        }
+
+        label_len = dash - label;
+        name      = (char *) next;
+        memcpy(name, label, label_len);
+        name[label_len] = '\0';
+
+        body = next + label_len + 1;
+
+        /* The body runs a line at a time until the END line.  Its characters
+         * are gathered in the arena and decoded there in one go. */
+        for (p = eol; 1; p = eol) {
+            size_t n;
+
+            if (end <= p) {
+                goto fail;
+            }
+            p++;
+            eol = line_end(p, end);
+            n   = trim(p, eol - p);
+
+            if ((END_LEN <= n) && (0 == memcmp(p, END, END_LEN))) {
+                if ((END_LEN + label_len + DASHES_LEN != n)
+                    || (0 != memcmp(&p[END_LEN], label, label_len))
+                    || (0 != memcmp(&p[END_LEN + label_len], DASHES, DASHES_LEN)))
+                {
+                    goto fail;
+                }
+                break;
+            }
+
+            memcpy(&body[body_len], p, n);
+            body_len += n;
+        }
+
+        if (body_len) {
+            body_len = body_decode(body, body_len);
+            if (0 == body_len) {
+                goto fail;
+            }
+        }
+
+        if (0 != add_entry(&rv, &size, name, body, body_len)) {
+            goto fail;
+        }
+        next = body + body_len;
+        p    = eol;
+    }
+
+    if (0 == rv.count) {
+        goto fail;
+    }
+
+    /* The bundle was only an upper bound, so hand back the slack.  Shrinking
+     * may still move the arena, and the old pointers must not be used once it
+     * has, so the entries are rebuilt from the new arena.  It holds each
+     * label, its '\0' and then its body, one entry after the other. */
+    arena = realloc(rv.arena, next - rv.arena);
+    if (arena) {
+        size_t off = 0;
+
+        for (size_t i = 0; i < rv.count; i++) {
+            rv.entries[i].label = (const char *) &arena[off];
+            off += strlen(rv.entries[i].label) + 1;
+            rv.entries[i].der = &arena[off];
+            off += rv.entries[i].der_len;
+        }
+        rv.arena = arena;
+    }
+
+    *out = rv;
+    return rv.count;
+
+fail:
+    b64_pem_free(&rv);
+    return 0;
+}
+
+
+void b64_pem_free(b64_pem_t *pem)
+{
+    if (pem) {
+        free(pem->entries);
+        free(pem->arena);
+        memset(pem, 0, sizeof(*pem));
+    }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                             Internal functions                             */
+/*----------------------------------------------------------------------------*/
+
+/* Finds the first s in [p, end), or returns NULL. */
+static const uint8_t *find(const uint8_t *p, const uint8_t *end, const char *s, size_t n)
+{
+    while (n <= (size_t) (end - p)) {
+        const uint8_t *c = memchr(p, s[0], (end - p) - n + 1);
+
+        if (!c) {
+            break;
+        }
+        if (0 == memcmp(c, s, n)) {
+            return c;
+        }
+        p = c + 1;
+    }
+
+    return NULL;
+}
+
+/* Returns the '\n' that ends the line, or end. */
+static const uint8_t *line_end(const uint8_t *p, const uint8_t *end)
+{
+    const uint8_t *c = memchr(p, '\n', end - p);
+
+    return c ? c : end;
+}
+
+/* Returns the length of the line without its trailing whitespace. */
+static size_t trim(const uint8_t *p, size_t n)
+{
+    while (n && ((' ' == p[n - 1]) || ('\t' == p[n - 1]) || ('\r' == p[n - 1]))) {
+        n--;
+    }
+
+    return n;
+}
+
+/* Decodes the n gathered characters of a body in place, returning 0 if they
+ * aren't whole, padded groups.  The padding is only looked for at the end;
+ * anywhere else the translation rejects it. */
+static size_t body_decode(uint8_t *body, size_t n)
+{
+    size_t padding = 0;
+
+    if (0 != (0x03 & n)) {
+        return 0;
+    }
+
+    if ('=' == body[n - 1]) {
+        padding++;
+        if ('=' == body[n - 2]) {
+            padding++;
+        }
+    }
+
+    /* Each group is read before its bytes are written over it. */
+    return b64_std_decode_body(body, n - padding, body);
+}
+
+static int add_entry(b64_pem_t *pem, size_t *size, const char *label, const uint8_t *der,
+                     size_t der_len)
+{
+    if (pem->count == *size) {
+        size_t grow           = *size ? *size * 2 : 16;
+        b64_pem_entry_t *list = realloc(pem->entries, grow * sizeof(b64_pem_entry_t));
+
+        if (!list) {
+            return -1;
+        }
+        pem->entries = list;
+        *size        = grow;
+    }
+
+    pem->entries[pem->count].label   = label;
+    pem->entries[pem->count].der     = der;
+    pem->entries[pem->count].der_len = der_len;
+    pem->count++;
+
+    return 0;
+}
@@ -0,0 +1,292 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "internal.h"
+#include "stats.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                   Macros                                   */
+/*----------------------------------------------------------------------------*/
+#if defined(B64_STATS) && !defined(__GNUC__)
+#error "The stats option requires GCC or clang atomics and thread locals."
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*                               Data Structures                              */
+/*----------------------------------------------------------------------------*/
+
+/* Each thread only ever writes to its own block, so the counters need no
+ * locks or atomic read-modify-writes.  When a thread exits, its counts are
+ * added to the retired totals and the block is zeroed and kept for the next
+ * new thread, so the number of blocks never exceeds the most threads that
+ * have counted at once. */
+struct block {
+    b64_stats_fn_t fn[B64_STATS_FN_COUNT];
+    struct block *next;      /* every block, in use or not */
+    struct block *next_free; /* the blocks waiting to be reused */
+};
+
+/*----------------------------------------------------------------------------*/
+/*                            File Scoped Variables                           */
+/*----------------------------------------------------------------------------*/
+static const char *const fn_names[B64_STATS_FN_COUNT] = {
+    [B64_STATS_ENCODE]                  = "b64_encode",
+    [B64_STATS_DECODE]                  = "b64_decode",
+    [B64_STATS_ENCODE_WITH_ALLOC]       = "b64_encode_with_alloc",
+    [B64_STATS_DECODE_WITH_ALLOC]       = "b64_decode_with_alloc",
+    [B64_STATS_URL_ENCODE]              = "b64url_encode",
+    [B64_STATS_URL_DECODE]              = "b64url_decode",
+    [B64_STATS_URL_ENCODE_WITH_ALLOC]   = "b64url_encode_with_alloc",
+    [B64_STATS_URL_DECODE_WITH_ALLOC]   = "b64url_decode_with_alloc",
+    [B64_STATS_ENCODE_APPEND]           = "b64_encode_append",
+    [B64_STATS_DECODE_APPEND]           = "b64_decode_append",
+    [B64_STATS_URL_ENCODE_APPEND]       = "b64url_encode_append",
+    [B64_STATS_URL_DECODE_APPEND]       = "b64url_decode_append",
+    [B64_STATS_DECODE_JSON]             = "b64_decode_json",
+    [B64_STATS_URL_DECODE_JSON]         = "b64url_decode_json",
+    [B64_STATS_DECODE_FLAGS]            = "b64_decode_flags",
+    [B64_STATS_DECODE_FLAGS_WITH_ALLOC] = "b64_decode_flags_with_alloc",
+    [B64_STATS_ENCODE_UTF16]            = "b64_encode_utf16",
+    [B64_STATS_DECODE_UTF16]            = "b64_decode_utf16",
+    [B64_STATS_URL_ENCODE_UTF16]        = "b64url_encode_utf16",
+    [B64_STATS_URL_DECODE_UTF16]        = "b64url_decode_utf16",
+    [B64_STATS_DECODE_CHUNKED]          = "b64_decode_chunked",
+};
+
+static const char *const kernel_names[B64_STATS_KERNEL_COUNT] = {
+    [B64_STATS_KERNEL_SCALAR]        = "scalar",
+    [B64_STATS_KERNEL_SWAR]          = "swar",
+    [B64_STATS_KERNEL_TABLEFREE]     = "tablefree",
+    [B64_STATS_KERNEL_CONSTANT_TIME] = "constant_time",
+};
+
+#ifdef B64_STATS
+static __thread struct block *tls_block = NULL;
+
+static struct block *blocks    = NULL;
+static struct block *free_list = NULL;
+
+/* The counts of the threads that have exited. */
+static b64_stats_fn_t retired[B64_STATS_FN_COUNT];
+
+/* The sum of all blocks at the last reset. */
+static b64_stats_fn_t baseline[B64_STATS_FN_COUNT];
+
+/* Retires a thread's block when the thread exits. */
+static pthread_once_t key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t key;
+static int have_key = 0;
+
+/* Serializes b64_stats_snapshot(), b64_stats_reset() and the handing out and
+ * retiring of blocks with each other. */
+static pthread_mutex_t busy = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*                             Function Prototypes                            */
+/*----------------------------------------------------------------------------*/
+#ifdef B64_STATS
+static struct block *block_new(void);
+static void block_retire(void *arg);
+static void key_create(void);
+static void add(uint64_t *counter, uint64_t n);
+static void add_all(b64_stats_fn_t *dst, const b64_stats_fn_t *src);
+static void sum(b64_stats_fn_t *out);
+static void lock(void);
+static void unlock(void);
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*                             External Functions                             */
+/*----------------------------------------------------------------------------*/
+void b64_stats_snapshot(b64_stats_t *out)
+{
+    if (!out) {
+        return;
+    }
+
+    memset(out, 0, sizeof(*out));
+
+#ifdef B64_STATS
+    out->enabled = 1;
+
+    lock();
+    sum(out->fn);
+    for (size_t i = 0; i < B64_STATS_FN_COUNT; i++) {
+        uint64_t *now        = (uint64_t *) &out->fn[i];
+        const uint64_t *then = (const uint64_t *) &baseline[i];
+
+        for (size_t j = 0; j < sizeof(b64_stats_fn_t) / sizeof(uint64_t); j++) {
+            now[j] -= then[j];
+        }
+    }
+    unlock();
+#endif
+}
+
+
+void b64_stats_reset(void)
+{
+#ifdef B64_STATS
+    lock();
+    sum(baseline);
+    unlock();
+#endif
+}
+
+
+const char *b64_stats_fn_name(enum b64_stats_fn fn)
+{
+    if ((unsigned) fn < B64_STATS_FN_COUNT) {
+        return fn_names[fn];
+    }
+    return NULL;
+}
+
+
+const char *b64_stats_kernel_name(enum b64_stats_kernel kernel)
+{
+    if ((unsigned) kernel < B64_STATS_KERNEL_COUNT) {
+        return kernel_names[kernel];
+    }
+    return NULL;
+}
+
+
+#ifdef B64_STATS
+void b64_stats_record(enum b64_stats_fn fn, enum b64_stats_kernel kernel, size_t len, int ok)
+{
+    struct block *b = tls_block;
+    b64_stats_fn_t *s;
+    size_t bucket = 0;
+
+    if (!b) {
+        b = block_new();
+        if (!b) {
+            return;
+        }
+    }
+
+    if (len) {
+        bucket = (size_t) (64 - __builtin_clzll((unsigned long long) len));
+    }
+
+    s = &b->fn[fn];
+    add(&s->calls, 1);
+    add(&s->bytes, len);
+    add(&s->kernel[kernel], 1);
+    add(&s->size_log2[bucket], 1);
+    if (!ok) {
+        add(&s->errors, 1);
+    }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                             Internal functions                             */
+/*----------------------------------------------------------------------------*/
+
+/* Gives the calling thread a retired block, or a new one pushed onto the
+ * list of every block. */
+static struct block *block_new(void)
+{
+    struct block *b;
+
+    pthread_once(&key_once, key_create);
+
+    lock();
+    b = free_list;
+    if (b) {
+        free_list    = b->next_free;
+        b->next_free = NULL;
+    } else {
+        b = calloc(1, sizeof(struct block));
+        if (b) {
+            b->next = blocks;
+            __atomic_store_n(&blocks, b, __ATOMIC_RELEASE);
+        }
+    }
+    unlock();
+
+    if (b) {
+        /* Without the key the block still counts, it just isn't reused. */
+        if (have_key) {
+            pthread_setspecific(key, b);
+        }
+        tls_block = b;
+    }
+
+    return b;
+}
+
+/* The key destructor: moves the exiting thread's counts to the retired
+ * totals, which leaves every sum unchanged, and frees the block for reuse. */
+static void block_retire(void *arg)
+{
+    struct block *b = arg;
+
+    lock();
+    add_all(retired, b->fn);
+    memset(b->fn, 0, sizeof(b->fn));
+    b->next_free = free_list;
+    free_list    = b;
+    unlock();
+
+    tls_block = NULL;
+}
+
+static void key_create(void)
+{
+    have_key = (0 == pthread_key_create(&key, block_retire));
+}
+
+/* Only the owning thread writes a counter, so a relaxed load and store is
+ * enough for readers on other threads to see whole values. */
+static void add(uint64_t *counter, uint64_t n)
+{
+    __atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + n, __ATOMIC_RELAXED);
+}
+
+/* Adds every counter of src to dst. */
+static void add_all(b64_stats_fn_t *dst, const b64_stats_fn_t *src)
+{
+    for (size_t i = 0; i < B64_STATS_FN_COUNT; i++) {
+        uint64_t *d       = (uint64_t *) &dst[i];
+        const uint64_t *s = (const uint64_t *) &src[i];
+
+        for (size_t j = 0; j < sizeof(b64_stats_fn_t) / sizeof(uint64_t); j++) {
+            d[j] += __atomic_load_n(&s[j], __ATOMIC_RELAXED);
+        }
+    }
+}
+
+/* Must be called with the lock held, so no block is retired part way. */
+static void sum(b64_stats_fn_t *out)
+{
+    struct block *b = __atomic_load_n(&blocks, __ATOMIC_ACQUIRE);
+
+    memcpy(out, retired, sizeof(retired));
+
+    for (; b; b = b->next) {
+        add_all(out, b->fn);
+    }
+}
+
+static void lock(void)
+{
+    pthread_mutex_lock(&busy);
+}
+
+static void unlock(void)
+{
+    pthread_mutex_unlock(&busy);
+}
+#endif
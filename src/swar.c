@@ -0,0 +1,361 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "internal.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                   Macros                                   */
+/*----------------------------------------------------------------------------*/
+
+/* The kernel treats a uint64_t as 8 byte lanes.  Lane 0 is the most
+ * significant byte so the lanes are in the same order as the text. */
+#define ONES  0x0101010101010101ULL
+#define HIGHS 0x8080808080808080ULL
+#define LOWS  0x7f7f7f7f7f7f7f7fULL
+
+/* A byte value repeated in every lane. */
+#define LANES(b) (ONES * (uint8_t) (b))
+
+/*----------------------------------------------------------------------------*/
+/*                               Data Structures                              */
+/*----------------------------------------------------------------------------*/
+/* none */
+
+/*----------------------------------------------------------------------------*/
+/*                            File Scoped Variables                           */
+/*----------------------------------------------------------------------------*/
+/* none */
+
+/*----------------------------------------------------------------------------*/
+/*                             Function Prototypes                            */
+/*----------------------------------------------------------------------------*/
+static uint64_t load32(const uint8_t *in);
+static uint64_t load40(const uint8_t *in);
+static uint64_t load48(const uint8_t *in);
+static uint64_t load64(const uint8_t *in);
+static void store(uint8_t *out, uint64_t x, int n);
+static void store48(uint8_t *out, uint64_t x);
+static void store64(uint8_t *out, uint64_t x);
+static uint64_t spread(uint64_t x);
+static uint64_t gather(uint64_t v);
+static uint64_t spread16(uint64_t x);
+static uint64_t gather16(uint64_t v);
+static uint64_t spread32(uint64_t x);
+static uint64_t gather32(uint64_t v);
+static uint64_t ge(uint64_t v, uint8_t t);
+static uint64_t eq(uint64_t v, uint8_t c);
+static void split(int d, uint64_t *pos, uint64_t *neg);
+
+/*----------------------------------------------------------------------------*/
+/*                             External Functions                             */
+/*----------------------------------------------------------------------------*/
+size_t b64_swar_encode(const uint8_t *in, size_t len, uint8_t *out, uint8_t c62, uint8_t c63)
+{
+    uint64_t p62, n62, p63, n63;
+    size_t i = 0;
+
+    /* How far 62 and 63 are from where the digits' offset (and then 62's)
+     * would put them. */
+    split((int) c62 - ('0' - 52 + 62), &p62, &n62);
+    split((int) c63 - ((int) c62 + 1), &p63, &n63);
+
+    for (; i + 6 <= len; i += 6) {
+        uint64_t v   = spread(load48(&in[i]));
+        uint64_t g26 = ge(v, 26);
+        uint64_t g52 = ge(v, 52);
+        uint64_t g62 = ge(v, 62);
+        uint64_t g63 = ge(v, 63);
+        uint64_t pos = v + LANES('A') + g26 * ('a' - 'A' - 26) + g62 * p62 + g63 * p63;
+        uint64_t neg = g52 * ('a' - 26 - ('0' - 52)) + g62 * n62 + g63 * n63;
+
+        store64(out, pos - neg);
+        out += 8;
+    }
+
+    return i;
+}
+
+
+size_t b64_swar_decode(const uint8_t *in, size_t len, uint8_t *out,
+                       const uint8_t c62[2], const uint8_t c63[2])
+{
+    int mixed = (c62[0] != c62[1]) || (c63[0] != c63[1]);
+    uint64_t p62[2], n62[2], p63[2], n63[2];
+    size_t i = 0;
+
+    /* How far 62 and 63 are from their characters.  A repeated spelling
+     * must only be counted once. */
+    split(62 - (int) c62[0], &p62[0], &n62[0]);
+    split(63 - (int) c63[0], &p63[0], &n63[0]);
+    split((c62[0] == c62[1]) ? 0 : 62 - (int) c62[1], &p62[1], &n62[1]);
+    split((c63[0] == c63[1]) ? 0 : 63 - (int) c63[1], &p63[1], &n63[1]);
+
+    for (; i + 8 <= len; i += 8) {
+        uint64_t x = load64(&in[i]);
+        uint64_t upper, lower, digit, s62, s63, valid, pos, neg;
+
+        /* The range checks below only hold for 7-bit lanes. */
+        if (x & HIGHS) {
+            break;
+        }
+
+        upper = ge(x, 'A') - ge(x, 'Z' + 1);
+        lower = ge(x, 'a') - ge(x, 'z' + 1);
+        digit = ge(x, '0') - ge(x, '9' + 1);
+        s62   = eq(x, c62[0]);
+        s63   = eq(x, c63[0]);
+        valid = upper | lower | digit | s62 | s63;
+        pos   = x + digit * (52 - '0') + s62 * p62[0] + s63 * p63[0];
+        neg   = upper * 'A' + lower * ('a' - 26) + s62 * n62[0] + s63 * n63[0];
+
+        /* The second spellings are only checked for the mixed alphabet. */
+        if (mixed) {
+            s62 = eq(x, c62[1]);
+            s63 = eq(x, c63[1]);
+            valid |= s62 | s63;
+            pos += s62 * p62[1] + s63 * p63[1];
+            neg += s62 * n62[1] + s63 * n63[1];
+        }
+
+        if (ONES != valid) {
+            break;
+        }
+
+        store48(out, gather(pos - neg));
+        out += 6;
+    }
+
+    return i;
+}
+
+size_t b16_swar_encode(const uint8_t *in, size_t len, uint8_t *out)
+{
+    size_t i = 0;
+
+    for (; i + 4 <= len; i += 4) {
+        uint64_t v = spread16(load32(&in[i]));
+
+        store64(out, v + LANES('0') + ge(v, 10) * ('a' - '0' - 10));
+        out += 8;
+    }
+
+    return i;
+}
+
+
+size_t b16_swar_decode(const uint8_t *in, size_t len, uint8_t *out)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= len; i += 8) {
+        uint64_t x = load64(&in[i]);
+        uint64_t digit, upper, lower;
+
+        if (x & HIGHS) {
+            break;
+        }
+
+        digit = ge(x, '0') - ge(x, '9' + 1);
+        upper = ge(x, 'A') - ge(x, 'F' + 1);
+        lower = ge(x, 'a') - ge(x, 'f' + 1);
+        if (ONES != (digit | upper | lower)) {
+            break;
+        }
+
+        /* Every lane is in exactly one range, so nothing borrows. */
+        x -= digit * '0' + upper * ('A' - 10) + lower * ('a' - 10);
+        store(out, gather16(x), 4);
+        out += 4;
+    }
+
+    return i;
+}
+
+
+size_t b32_swar_encode(const uint8_t *in, size_t len, uint8_t *out, int hex)
+{
+    /* The letters start at the value 0 (base32) or 10 (base32hex), and the
+     * digits fill the rest. */
+    uint8_t letter = hex ? 10 : 0;
+    uint8_t count  = hex ? 22 : 26; /* the number of letters */
+    uint8_t digit  = hex ? 0 : 26;
+    uint8_t zero   = hex ? '0' : '2';
+    size_t i       = 0;
+
+    for (; i + 5 <= len; i += 5) {
+        uint64_t v       = spread32(load40(&in[i]));
+        uint64_t letters = ge(v, letter) - ge(v, (uint8_t) (letter + count));
+        uint64_t digits  = ONES - letters;
+
+        store64(out, v + letters * ('A' - letter) + digits * (uint8_t) (zero - digit));
+        out += 8;
+    }
+
+    return i;
+}
+
+
+size_t b32_swar_decode(const uint8_t *in, size_t len, uint8_t *out, int hex)
+{
+    uint8_t letter = hex ? 10 : 0;
+    uint8_t count  = hex ? 22 : 26; /* the number of letters */
+    uint8_t digit  = hex ? 0 : 26;
+    uint8_t zero   = hex ? '0' : '2';
+    size_t i       = 0;
+
+    for (; i + 8 <= len; i += 8) {
+        uint64_t x = load64(&in[i]);
+        uint64_t upper, lower, digits;
+
+        if (x & HIGHS) {
+            break;
+        }
+
+        upper  = ge(x, 'A') - ge(x, (uint8_t) ('A' + count));
+        lower  = ge(x, 'a') - ge(x, (uint8_t) ('a' + count));
+        digits = ge(x, zero) - ge(x, (uint8_t) (zero + 32 - count));
+        if (ONES != (upper | lower | digits)) {
+            break;
+        }
+
+        x -= upper * ('A' - letter) + lower * ('a' - letter) + digits * (uint8_t) (zero - digit);
+        store(out, gather32(x), 5);
+        out += 5;
+    }
+
+    return i;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             Internal functions                             */
+/*----------------------------------------------------------------------------*/
+
+/* Byte at a time loads and stores keep the kernel independent of alignment
+ * and endianness; compilers fold them into single moves (plus a byte swap
+ * on little endian targets). */
+static uint64_t load32(const uint8_t *in)
+{
+    return ((uint64_t) in[0] << 24) | ((uint64_t) in[1] << 16) | ((uint64_t) in[2] << 8)
+         | (uint64_t) in[3];
+}
+
+static uint64_t load40(const uint8_t *in)
+{
+    return ((uint64_t) in[0] << 32) | load32(&in[1]);
+}
+
+static uint64_t load48(const uint8_t *in)
+{
+    return ((uint64_t) in[0] << 40) | ((uint64_t) in[1] << 32) | ((uint64_t) in[2] << 24)
+         | ((uint64_t) in[3] << 16) | ((uint64_t) in[4] << 8) | (uint64_t) in[5];
+}
+
+static uint64_t load64(const uint8_t *in)
+{
+    return ((uint64_t) in[0] << 56) | ((uint64_t) in[1] << 48) | load48(&in[2]);
+}
+
+/* Stores the low n bytes of x. */
+static void store(uint8_t *out, uint64_t x, int n)
+{
+    for (int i = 0; i < n; i++) {
+        out[i] = (uint8_t) (x >> (8 * (n - 1 - i)));
+    }
+}
+
+static void store48(uint8_t *out, uint64_t x)
+{
+    for (int i = 0; i < 6; i++) {
+        out[i] = (uint8_t) (x >> (40 - 8 * i));
+    }
+}
+
+static void store64(uint8_t *out, uint64_t x)
+{
+    for (int i = 0; i < 8; i++) {
+        out[i] = (uint8_t) (x >> (56 - 8 * i));
+    }
+}
+
+/* Moves each 6 bit group of the low 48 bits into its own lane: halves, then
+ * quarters, then eighths. */
+static uint64_t spread(uint64_t x)
+{
+    x = ((x & 0x0000ffffff000000ULL) << 8) | (x & 0x0000000000ffffffULL);
+    x = ((x & 0x00fff00000fff000ULL) << 4) | (x & 0x00000fff00000fffULL);
+    x = ((x & 0x0fc00fc00fc00fc0ULL) << 2) | (x & 0x003f003f003f003fULL);
+    return x;
+}
+
+/* The inverse of spread(). */
+static uint64_t gather(uint64_t v)
+{
+    v = ((v >> 2) & 0x0fc00fc00fc00fc0ULL) | (v & 0x003f003f003f003fULL);
+    v = ((v >> 4) & 0x00fff00000fff000ULL) | (v & 0x00000fff00000fffULL);
+    v = ((v >> 8) & 0x0000ffffff000000ULL) | (v & 0x0000000000ffffffULL);
+    return v;
+}
+
+/* Moves each 4 bit group of the low 32 bits into its own lane. */
+static uint64_t spread16(uint64_t x)
+{
+    x = ((x & 0x00000000ffff0000ULL) << 16) | (x & 0x000000000000ffffULL);
+    x = ((x & 0x0000ff000000ff00ULL) << 8) | (x & 0x000000ff000000ffULL);
+    x = ((x & 0x00f000f000f000f0ULL) << 4) | (x & 0x000f000f000f000fULL);
+    return x;
+}
+
+/* The inverse of spread16(). */
+static uint64_t gather16(uint64_t v)
+{
+    v = ((v >> 4) & 0x00f000f000f000f0ULL) | (v & 0x000f000f000f000fULL);
+    v = ((v >> 8) & 0x0000ff000000ff00ULL) | (v & 0x000000ff000000ffULL);
+    v = ((v >> 16) & 0x00000000ffff0000ULL) | (v & 0x000000000000ffffULL);
+    return v;
+}
+
+/* Moves each 5 bit group of the low 40 bits into its own lane. */
+static uint64_t spread32(uint64_t x)
+{
+    x = ((x & 0x000000fffff00000ULL) << 12) | (x & 0x00000000000fffffULL);
+    x = ((x & 0x000ffc00000ffc00ULL) << 6) | (x & 0x000003ff000003ffULL);
+    x = ((x & 0x03e003e003e003e0ULL) << 3) | (x & 0x001f001f001f001fULL);
+    return x;
+}
+
+/* The inverse of spread32(). */
+static uint64_t gather32(uint64_t v)
+{
+    v = ((v >> 3) & 0x03e003e003e003e0ULL) | (v & 0x001f001f001f001fULL);
+    v = ((v >> 6) & 0x000ffc00000ffc00ULL) | (v & 0x000003ff000003ffULL);
+    v = ((v >> 12) & 0x000000fffff00000ULL) | (v & 0x00000000000fffffULL);
+    return v;
+}
+
+/* 0x01 in each lane of v that is >= t, otherwise 0x00.  Every lane of v must
+ * be below 0x80 and t at most 0x80 so no lane carries into the next. */
+static uint64_t ge(uint64_t v, uint8_t t)
+{
+    return ((v + LANES(0x80 - t)) & HIGHS) >> 7;
+}
+
+/* 0x01 in each lane of v that equals c, otherwise 0x00. */
+static uint64_t eq(uint64_t v, uint8_t c)
+{
+    uint64_t x = v ^ LANES(c);
+
+    return (~(((x & LOWS) + LOWS) | x) & HIGHS) >> 7;
+}
+
+/* Lane offsets are applied as a positive and a negative part rather than
+ * modulo 256, so that plain 64 bit addition and subtraction never carry or
+ * borrow between lanes.  This holds as long as the characters for 62 and 63
+ * are printable ASCII punctuation, as they are in every supported alphabet. */
+static void split(int d, uint64_t *pos, uint64_t *neg)
+{
+    *pos = (0 < d) ? (uint64_t) d : 0;
+    *neg = (0 < d) ? 0 : (uint64_t) -d;
+}
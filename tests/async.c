@@ -0,0 +1,305 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+#define _POSIX_C_SOURCE 200809L
+
+#include <CUnit/Basic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../include/trower-base64/async.h"
+#include "../include/trower-base64/base64.h"
+
+static uint8_t *random_bytes(size_t len)
+{
+    uint8_t *p = malloc(len);
+
+    for (size_t i = 0; p && i < len; i++) {
+        p[i] = (uint8_t) rand();
+    }
+    return p;
+}
+
+void test_create(void)
+{
+    b64_pool_config_t bad = { .workers = 1, .quantum = 2 };
+    b64_pool_t *pool;
+    uint8_t buf[8];
+
+    CU_ASSERT(NULL == b64_pool_create(&bad));
+    b64_pool_destroy(NULL);
+
+    pool = b64_pool_create(NULL);
+    CU_ASSERT_FATAL(NULL != pool);
+
+    CU_ASSERT(NULL == b64_encode_async(NULL, buf, 1, buf, NULL, NULL, -1));
+    CU_ASSERT(NULL == b64_encode_async(pool, NULL, 1, buf, NULL, NULL, -1));
+    CU_ASSERT(NULL == b64_encode_async(pool, buf, 0, buf, NULL, NULL, -1));
+    CU_ASSERT(NULL == b64_encode_async(pool, buf, B64_MAX_ENCODE_LEN + 1, buf, NULL, NULL, -1));
+    CU_ASSERT(NULL == b64_decode_async(pool, buf, 4, NULL, NULL, NULL, -1));
+
+    CU_ASSERT(0 == b64_job_done(NULL));
+    CU_ASSERT(0 == b64_job_wait(NULL));
+    CU_ASSERT(0 == b64_job_result(NULL));
+    b64_job_free(NULL);
+
+    b64_pool_destroy(pool);
+}
+
+void test_round_trip(void)
+{
+    /* Small quanta so every job is split many times over. */
+    b64_pool_config_t config = { .workers = 4, .quantum = 301 };
+    b64_pool_t *pool         = b64_pool_create(&config);
+    size_t sizes[]           = { 1, 2, 3, 299, 300, 301, 302, 3000, 100000, 100001, 100002 };
+
+    CU_ASSERT_FATAL(NULL != pool);
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        size_t len      = sizes[i];
+        size_t enc_len  = b64_get_encoded_buffer_size(len);
+        uint8_t *raw    = random_bytes(len);
+        uint8_t *expect = malloc(enc_len);
+        uint8_t *enc    = malloc(enc_len);
+        uint8_t *dec    = malloc(b64_get_decoded_buffer_size(enc_len));
+        b64_job_t *job;
+
+        CU_ASSERT_FATAL(raw && expect && enc && dec);
+        b64_encode(raw, len, expect);
+
+        job = b64_encode_async(pool, raw, len, enc, NULL, NULL, -1);
+        CU_ASSERT_FATAL(NULL != job);
+        CU_ASSERT(enc_len == b64_job_wait(job));
+        CU_ASSERT(b64_job_done(job));
+        CU_ASSERT(enc_len == b64_job_result(job));
+        CU_ASSERT(0 == memcmp(expect, enc, enc_len));
+        b64_job_free(job);
+
+        job = b64_decode_async(pool, enc, enc_len, dec, NULL, NULL, -1);
+        CU_ASSERT_FATAL(NULL != job);
+        CU_ASSERT(len == b64_job_wait(job));
+        CU_ASSERT(0 == memcmp(raw, dec, len));
+        b64_job_free(job);
+
+        free(raw);
+        free(expect);
+        free(enc);
+        free(dec);
+    }
+
+    b64_pool_destroy(pool);
+}
+
+void test_decode_errors(void)
+{
+    b64_pool_config_t config = { .workers = 2, .quantum = 3 };
+    b64_pool_t *pool         = b64_pool_create(&config);
+    uint8_t out[32];
+    struct {
+        const char *enc;
+        size_t expect;
+    } cases[] = {
+        { "TWFuTWFuTWFu", 9 },
+        { "TWFuTWFuTWE=", 8 },
+        { "TWFuTWFuTQ==", 7 },
+        { "TWFuTQ==TWFu", 0 }, /* padding in a middle quantum */
+        { "TWFuTW!uTWFu", 0 }, /* bad character in a middle quantum */
+        { "TWFuTWFuTWF", 0 },  /* short final quantum */
+        { "T", 0 },
+    };
+
+    CU_ASSERT_FATAL(NULL != pool);
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        size_t len     = strlen(cases[i].enc);
+        b64_job_t *job = b64_decode_async(pool, (const uint8_t *) cases[i].enc, len, out, NULL,
+                                          NULL, -1);
+
+        CU_ASSERT_FATAL(NULL != job);
+        CU_ASSERT(cases[i].expect == b64_job_wait(job));
+        CU_ASSERT(b64_decode((const uint8_t *) cases[i].enc, len, out) == cases[i].expect);
+        b64_job_free(job);
+    }
+
+    b64_pool_destroy(pool);
+}
+
+static void on_done(b64_job_t *job, void *user)
+{
+    size_t *result = user;
+
+    *result = b64_job_result(job);
+
+    /* The callback may release the job. */
+    b64_job_free(job);
+}
+
+void test_notify(void)
+{
+    b64_pool_config_t config = { .workers = 2, .quantum = 30 };
+    b64_pool_t *pool         = b64_pool_create(&config);
+    uint8_t out[128];
+    size_t result = 0;
+    uint64_t count;
+    b64_job_t *job;
+    int fds[2];
+
+    CU_ASSERT_FATAL(NULL != pool);
+    CU_ASSERT_FATAL(0 == pipe(fds));
+
+    /* The callback runs and then the descriptor is written, as for eventfd. */
+    job = b64_encode_async(pool, (const uint8_t *) "Hello, world.  Hello, world.  Hello!", 36, out,
+                           on_done, &result, fds[1]);
+    CU_ASSERT_FATAL(NULL != job);
+    CU_ASSERT(sizeof(count) == read(fds[0], &count, sizeof(count)));
+    CU_ASSERT(1 == count);
+    CU_ASSERT(48 == result);
+    CU_ASSERT(0 == memcmp(out, "SGVsbG8sIHdvcmxkLiAgSGVsbG8sIHdvcmxkLiAgSGVsbG8h", 48));
+
+    /* A job freed before it completes still notifies. */
+    job = b64_decode_async(pool, (const uint8_t *) "SGVsbG8h", 8, out, NULL, NULL, fds[1]);
+    CU_ASSERT_FATAL(NULL != job);
+    b64_job_free(job);
+    CU_ASSERT(sizeof(count) == read(fds[0], &count, sizeof(count)));
+    CU_ASSERT(0 == memcmp(out, "Hello!", 6));
+
+    close(fds[0]);
+    close(fds[1]);
+    b64_pool_destroy(pool);
+}
+
+void test_small_jobs_first(void)
+{
+    /* One worker makes the ordering deterministic. */
+    b64_pool_config_t config = { .workers = 1, .quantum = 300 };
+    b64_pool_t *pool         = b64_pool_create(&config);
+    size_t len               = 3 * 1024 * 1024;
+    uint8_t *raw             = random_bytes(len);
+    uint8_t *out             = malloc(b64_get_encoded_buffer_size(len));
+    uint8_t small[8];
+    b64_job_t *large, *job;
+
+    CU_ASSERT_FATAL(NULL != pool);
+    CU_ASSERT_FATAL(raw && out);
+
+    large = b64_encode_async(pool, raw, len, out, NULL, NULL, -1);
+    job   = b64_encode_async(pool, (const uint8_t *) "small", 5, small, NULL, NULL, -1);
+    CU_ASSERT_FATAL(large && job);
+
+    /* The small job only waits for a quantum or two of the large one. */
+    CU_ASSERT(8 == b64_job_wait(job));
+    CU_ASSERT(0 == memcmp(small, "c21hbGw=", 8));
+    CU_ASSERT(!b64_job_done(large));
+
+    CU_ASSERT(b64_get_encoded_buffer_size(len) == b64_job_wait(large));
+
+    b64_job_free(job);
+    b64_job_free(large);
+    free(raw);
+    free(out);
+    b64_pool_destroy(pool);
+}
+
+void test_destroy_drains(void)
+{
+    b64_pool_config_t config = { .workers = 3, .quantum = 3 };
+    b64_pool_t *pool         = b64_pool_create(&config);
+    uint8_t out[64][8];
+    b64_job_t *jobs[64];
+
+    CU_ASSERT_FATAL(NULL != pool);
+
+    for (size_t i = 0; i < 64; i++) {
+        jobs[i] = b64_encode_async(pool, (const uint8_t *) "foobar", 6, out[i], NULL, NULL, -1);
+        CU_ASSERT_FATAL(NULL != jobs[i]);
+    }
+
+    /* Every job completes, and stays readable after the pool is gone. */
+    b64_pool_destroy(pool);
+
+    for (size_t i = 0; i < 64; i++) {
+        CU_ASSERT(b64_job_done(jobs[i]));
+        CU_ASSERT(8 == b64_job_wait(jobs[i]));
+        CU_ASSERT(0 == memcmp(out[i], "Zm9vYmFy", 8));
+        b64_job_free(jobs[i]);
+    }
+}
+
+void test_idle_workers(void)
+{
+    /* More workers than jobs and 1000 quanta per job keep them stealing. */
+    b64_pool_config_t config = { .workers = 8, .quantum = 3 };
+    b64_pool_t *pool         = b64_pool_create(&config);
+    struct timespec pause    = { 0, 200 * 1000 * 1000 };
+    size_t len               = 3000;
+    uint8_t *raw             = random_bytes(len);
+    uint8_t expected[4000];
+    uint8_t out[4][4000];
+    b64_job_t *jobs[4];
+    clock_t start;
+
+    CU_ASSERT_FATAL(NULL != pool);
+    CU_ASSERT_FATAL(NULL != raw);
+
+    b64_encode(raw, len, expected);
+    for (size_t i = 0; i < 4; i++) {
+        jobs[i] = b64_encode_async(pool, raw, len, out[i], NULL, NULL, -1);
+        CU_ASSERT_FATAL(NULL != jobs[i]);
+    }
+    for (size_t i = 0; i < 4; i++) {
+        CU_ASSERT(sizeof(expected) == b64_job_wait(jobs[i]));
+        CU_ASSERT(0 == memcmp(out[i], expected, sizeof(expected)));
+        b64_job_free(jobs[i]);
+    }
+
+    /* Idle workers sleep instead of spinning. */
+    start = clock();
+    nanosleep(&pause, NULL);
+    CU_ASSERT(clock() - start < CLOCKS_PER_SEC / 20);
+
+    free(raw);
+    b64_pool_destroy(pool);
+}
+
+void add_suites(CU_pSuite *suite)
+{
+    *suite = CU_add_suite("Base64 async job tests", NULL, NULL);
+    CU_add_test(*suite, "Test create               ", test_create);
+    CU_add_test(*suite, "Test round trip           ", test_round_trip);
+    CU_add_test(*suite, "Test decode errors        ", test_decode_errors);
+    CU_add_test(*suite, "Test notify               ", test_notify);
+    CU_add_test(*suite, "Test small jobs first     ", test_small_jobs_first);
+    CU_add_test(*suite, "Test destroy drains       ", test_destroy_drains);
+    CU_add_test(*suite, "Test idle workers         ", test_idle_workers);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             External Functions                             */
+/*----------------------------------------------------------------------------*/
+int main(void)
+{
+    unsigned rv     = 1;
+    CU_pSuite suite = NULL;
+
+    if (CUE_SUCCESS == CU_initialize_registry()) {
+        add_suites(&suite);
+
+        if (NULL != suite) {
+            CU_basic_set_mode(CU_BRM_VERBOSE);
+            CU_basic_run_tests();
+            printf("\n");
+            CU_basic_show_failures(CU_get_failure_list());
+            printf("\n\n");
+            rv = CU_get_number_of_tests_failed();
+        }
+
+        CU_cleanup_registry();
+    }
+
+    if (0 != rv) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,167 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+#include <CUnit/Basic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/trower-base64/base16.h"
+
+void test_vectors(void)
+{
+    // clang-format off
+    struct test {
+        const char *raw;
+        const char *enc;
+    } tests[] = {
+        { "f",      "66"           },
+        { "fo",     "666f"         },
+        { "foo",    "666f6f"       },
+        { "foob",   "666f6f62"     },
+        { "fooba",  "666f6f6261"   },
+        { "foobar", "666f6f626172" },
+        { "\x01\x23\x45\x67\x89\xab\xcd\xef\xfe", "0123456789abcdeffe" },
+    };
+    // clang-format on
+
+    for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+        size_t len = strlen(tests[i].raw);
+        uint8_t buf[32];
+
+        CU_ASSERT(strlen(tests[i].enc) == b16_get_encoded_buffer_size(len));
+        b16_encode((const uint8_t *) tests[i].raw, len, buf);
+        CU_ASSERT(0 == memcmp(buf, tests[i].enc, 2 * len));
+
+        CU_ASSERT(len == b16_get_decoded_buffer_size(2 * len));
+        CU_ASSERT(len == b16_decode((const uint8_t *) tests[i].enc, 2 * len, buf));
+        CU_ASSERT(0 == memcmp(buf, tests[i].raw, len));
+    }
+
+    CU_ASSERT(3 == b16_decode((const uint8_t *) "ABcdEF", 6, (uint8_t[3]) { 0 }));
+    CU_ASSERT(0 == b16_get_encoded_buffer_size(0));
+    CU_ASSERT(0 == b16_get_decoded_buffer_size(7));
+}
+
+void test_round_trip(void)
+{
+    uint8_t raw[100];
+    uint8_t enc[200];
+    uint8_t out[100];
+
+    for (size_t i = 0; i < sizeof(raw); i++) {
+        raw[i] = (uint8_t) (i * 167 + 5);
+    }
+
+    for (size_t len = 1; len <= sizeof(raw); len++) {
+        b16_encode(raw, len, enc);
+        for (size_t i = 0; i < len; i++) {
+            CU_ASSERT("0123456789abcdef"[raw[i] >> 4] == enc[2 * i]);
+            CU_ASSERT("0123456789abcdef"[raw[i] & 15] == enc[2 * i + 1]);
+        }
+        CU_ASSERT(len == b16_decode(enc, 2 * len, out));
+        CU_ASSERT(0 == memcmp(raw, out, len));
+    }
+}
+
+void test_errors(void)
+{
+    uint8_t enc[40];
+    uint8_t out[20];
+
+    /* A bad character anywhere, including inside a whole 8 character block. */
+    for (size_t pos = 0; pos < sizeof(enc); pos++) {
+        const char bad[] = { 'g', 'G', '/', ':', '@', '`', ' ', '\0', (char) 0x80, (char) 0xb0 };
+
+        for (size_t i = 0; i < sizeof(bad); i++) {
+            memset(enc, '7', sizeof(enc));
+            enc[pos] = (uint8_t) bad[i];
+            CU_ASSERT(0 == b16_decode(enc, sizeof(enc), out));
+        }
+    }
+
+    CU_ASSERT(0 == b16_decode((const uint8_t *) "abc", 3, out));
+    CU_ASSERT(0 == b16_decode((const uint8_t *) "ab", 0, out));
+    CU_ASSERT(0 == b16_decode(NULL, 2, out));
+    CU_ASSERT(0 == b16_decode((const uint8_t *) "ab", 2, NULL));
+}
+
+void test_alloc_append(void)
+{
+    b64_buf_t buf = { 0 };
+    size_t len    = 99;
+    int over      = 99;
+    uint8_t *raw;
+    char *enc;
+
+    enc = b16_encode_with_alloc((const uint8_t *) "Man", 3, &len);
+    CU_ASSERT_FATAL(NULL != enc);
+    CU_ASSERT(6 == len);
+    CU_ASSERT(0 == strcmp(enc, "4d616e"));
+
+    raw = b16_decode_with_alloc((const uint8_t *) enc, len, &len);
+    CU_ASSERT_FATAL(NULL != raw);
+    CU_ASSERT(3 == len);
+    CU_ASSERT(0 == memcmp(raw, "Man", 3));
+    free(raw);
+    free(enc);
+
+    len = 99;
+    CU_ASSERT(NULL == b16_decode_with_alloc((const uint8_t *) "4d6x", 4, &len));
+    CU_ASSERT(0 == len);
+    CU_ASSERT(NULL == b16_decode_with_alloc((const uint8_t *) "4d6", 3, &len));
+    CU_ASSERT(NULL == b16_encode_with_alloc(NULL, 3, &len));
+
+    /* Lengths whose encoded size doesn't fit are rejected up front. */
+    CU_ASSERT(SIZE_MAX - 1 == b16_get_encoded_buffer_size_checked(B16_MAX_ENCODE_LEN, &over));
+    CU_ASSERT(0 == over);
+    CU_ASSERT(0 == b16_get_encoded_buffer_size_checked(B16_MAX_ENCODE_LEN + 1, &over));
+    CU_ASSERT(1 == over);
+    CU_ASSERT(NULL == b16_encode_with_alloc((const uint8_t *) "Man", B16_MAX_ENCODE_LEN + 1, &len));
+    CU_ASSERT(0 == b16_encode_append(&buf, (const uint8_t *) "Man", SIZE_MAX));
+
+    CU_ASSERT(6 == b16_encode_append(&buf, (const uint8_t *) "Man", 3));
+    CU_ASSERT(2 == b16_decode_append(&buf, (const uint8_t *) "2E2e", 4));
+    CU_ASSERT(0 == b16_decode_append(&buf, (const uint8_t *) "2E2x", 4));
+    CU_ASSERT(0 == b16_decode_append(NULL, (const uint8_t *) "2E", 2));
+    CU_ASSERT_FATAL(8 == buf.len);
+    CU_ASSERT(0 == memcmp(buf.data, "4d616e..", 8));
+    free(buf.data);
+}
+
+void add_suites(CU_pSuite *suite)
+{
+    *suite = CU_add_suite("Base16 tests", NULL, NULL);
+    CU_add_test(*suite, "Test vectors              ", test_vectors);
+    CU_add_test(*suite, "Test round trip           ", test_round_trip);
+    CU_add_test(*suite, "Test errors               ", test_errors);
+    CU_add_test(*suite, "Test alloc and append     ", test_alloc_append);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             External Functions                             */
+/*----------------------------------------------------------------------------*/
+int main(void)
+{
+    unsigned rv     = 1;
+    CU_pSuite suite = NULL;
+
+    if (CUE_SUCCESS == CU_initialize_registry()) {
+        add_suites(&suite);
+
+        if (NULL != suite) {
+            CU_basic_set_mode(CU_BRM_VERBOSE);
+            CU_basic_run_tests();
+            printf("\n");
+            CU_basic_show_failures(CU_get_failure_list());
+            printf("\n\n");
+            rv = CU_get_number_of_tests_failed();
+        }
+
+        CU_cleanup_registry();
+    }
+
+    if (0 != rv) {
+        return 1;
+    }
+    return 0;
+}
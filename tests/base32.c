@@ -0,0 +1,244 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+#include <CUnit/Basic.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/trower-base64/base32.h"
+
+struct family {
+    void (*encode)(const uint8_t *, const size_t, uint8_t *);
+    size_t (*decode)(const uint8_t *, const size_t, uint8_t *);
+    const char *alphabet;
+};
+
+static const struct family families[] = {
+    { b32_encode, b32_decode, "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567" },
+    { b32hex_encode, b32hex_decode, "0123456789ABCDEFGHIJKLMNOPQRSTUV" },
+};
+
+void test_vectors(void)
+{
+    /* RFC 4648, section 10 */
+    // clang-format off
+    struct test {
+        const char *raw;
+        const char *b32;
+        const char *b32hex;
+    } tests[] = {
+        { "f",      "MY======",         "CO======"         },
+        { "fo",     "MZXQ====",         "CPNG===="         },
+        { "foo",    "MZXW6===",         "CPNMU==="         },
+        { "foob",   "MZXW6YQ=",         "CPNMUOG="         },
+        { "fooba",  "MZXW6YTB",         "CPNMUOJ1"         },
+        { "foobar", "MZXW6YTBOI======", "CPNMUOJ1E8======" },
+    };
+    // clang-format on
+
+    for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+        size_t len = strlen(tests[i].raw);
+        size_t n   = strlen(tests[i].b32);
+        uint8_t buf[32];
+
+        CU_ASSERT(n == b32_get_encoded_buffer_size(len));
+        CU_ASSERT(len <= b32_get_decoded_buffer_size(n));
+
+        b32_encode((const uint8_t *) tests[i].raw, len, buf);
+        CU_ASSERT(0 == memcmp(buf, tests[i].b32, n));
+        b32hex_encode((const uint8_t *) tests[i].raw, len, buf);
+        CU_ASSERT(0 == memcmp(buf, tests[i].b32hex, n));
+
+        CU_ASSERT(len == b32_decode((const uint8_t *) tests[i].b32, n, buf));
+        CU_ASSERT(0 == memcmp(buf, tests[i].raw, len));
+        CU_ASSERT(len == b32hex_decode((const uint8_t *) tests[i].b32hex, n, buf));
+        CU_ASSERT(0 == memcmp(buf, tests[i].raw, len));
+    }
+
+    /* A typical TOTP secret: lower case and unpadded. */
+    CU_ASSERT(6 == b32_decode((const uint8_t *) "mzxw6ytboi", 10, (uint8_t[8]) { 0 }));
+
+    CU_ASSERT(0 == b32_get_encoded_buffer_size(0));
+    CU_ASSERT(5 == b32_get_decoded_buffer_size(8));
+    CU_ASSERT(4 == b32_get_decoded_buffer_size(7));
+    CU_ASSERT(0 == b32_get_decoded_buffer_size(6));
+    CU_ASSERT(0 == b32_get_decoded_buffer_size(9));
+}
+
+void test_round_trip(void)
+{
+    uint8_t raw[200];
+    uint8_t enc[330];
+    uint8_t out[200];
+
+    for (size_t i = 0; i < sizeof(raw); i++) {
+        raw[i] = (uint8_t) (i * 131 + 17);
+    }
+
+    for (size_t f = 0; f < sizeof(families) / sizeof(families[0]); f++) {
+        for (size_t len = 1; len <= sizeof(raw); len++) {
+            size_t n = b32_get_encoded_buffer_size(len);
+            size_t bits;
+
+            families[f].encode(raw, len, enc);
+
+            /* Check the characters against a bit at a time reference. */
+            for (bits = 0; bits < len * 8; bits += 5) {
+                unsigned v = 0;
+
+                for (size_t b = bits; b < bits + 5; b++) {
+                    v = (v << 1) | ((b < len * 8) ? (1 & (raw[b / 8] >> (7 - b % 8))) : 0);
+                }
+                CU_ASSERT(families[f].alphabet[v] == enc[bits / 5]);
+            }
+            for (size_t i = bits / 5; i < n; i++) {
+                CU_ASSERT('=' == enc[i]);
+            }
+
+            CU_ASSERT(len == families[f].decode(enc, n, out));
+            CU_ASSERT(0 == memcmp(raw, out, len));
+
+            /* Unpadded and lower case. */
+            for (size_t i = 0; i < n; i++) {
+                enc[i] = (uint8_t) tolower(enc[i]);
+            }
+            CU_ASSERT(len == families[f].decode(enc, bits / 5, out));
+            CU_ASSERT(0 == memcmp(raw, out, len));
+        }
+    }
+}
+
+void test_errors(void)
+{
+    uint8_t enc[40];
+    uint8_t out[25];
+
+    /* A bad character anywhere, including inside a whole 8 character block. */
+    for (size_t pos = 0; pos < sizeof(enc); pos++) {
+        const char bad_std[] = { '0', '1', '8', '9', '=', '+', '@', '[', '{', (char) 0xc1 };
+        const char bad_hex[] = { 'W', 'w', 'Z', '/', ':', '=', '@', '`', '\0', (char) 0x80 };
+
+        for (size_t i = 0; i < sizeof(bad_std); i++) {
+            /* A '=' at the very end is valid padding. */
+            int last = (sizeof(enc) - 1 == pos);
+
+            memset(enc, 'Q', sizeof(enc));
+            enc[pos] = (uint8_t) bad_std[i];
+            CU_ASSERT((last && '=' == enc[pos]) || (0 == b32_decode(enc, sizeof(enc), out)));
+
+            memset(enc, 'Q', sizeof(enc));
+            enc[pos] = (uint8_t) bad_hex[i];
+            CU_ASSERT((last && '=' == enc[pos]) || (0 == b32hex_decode(enc, sizeof(enc), out)));
+        }
+    }
+
+    /* Padding must complete a group of 8, and only to a valid length. */
+    CU_ASSERT(0 == b32_decode((const uint8_t *) "MY=====", 7, out));
+    CU_ASSERT(0 == b32_decode((const uint8_t *) "M=======", 8, out));
+    CU_ASSERT(0 == b32_decode((const uint8_t *) "MZX=====", 8, out));
+    CU_ASSERT(0 == b32_decode((const uint8_t *) "MZXW6Y==", 8, out));
+    CU_ASSERT(0 == b32_decode((const uint8_t *) "========", 8, out));
+    CU_ASSERT(0 == b32_decode((const uint8_t *) "MZXW6YQ=MZXW6YQ=", 16, out));
+    CU_ASSERT(0 == b32_decode((const uint8_t *) "MZX", 3, out));
+    CU_ASSERT(0 == b32_decode((const uint8_t *) "M", 1, out));
+    CU_ASSERT(0 == b32_decode((const uint8_t *) "MZXW6Y", 6, out));
+    CU_ASSERT(0 == b32_decode((const uint8_t *) "MY", 0, out));
+    CU_ASSERT(0 == b32_decode(NULL, 8, out));
+    CU_ASSERT(0 == b32_decode((const uint8_t *) "MY======", 8, NULL));
+}
+
+void test_alloc_append(void)
+{
+    b64_buf_t buf = { 0 };
+    size_t len    = 99;
+    int over      = 99;
+    uint8_t *raw;
+    char *enc;
+
+    enc = b32_encode_with_alloc((const uint8_t *) "foob", 4, &len);
+    CU_ASSERT_FATAL(NULL != enc);
+    CU_ASSERT(8 == len);
+    CU_ASSERT(0 == strcmp(enc, "MZXW6YQ="));
+
+    /* Padded input is still allocated exactly. */
+    raw = b32_decode_with_alloc((const uint8_t *) enc, len, &len);
+    CU_ASSERT_FATAL(NULL != raw);
+    CU_ASSERT(4 == len);
+    CU_ASSERT(0 == memcmp(raw, "foob", 4));
+    free(raw);
+    free(enc);
+
+    enc = b32hex_encode_with_alloc((const uint8_t *) "f", 1, NULL);
+    CU_ASSERT_FATAL(NULL != enc);
+    CU_ASSERT(0 == strcmp(enc, "CO======"));
+    raw = b32hex_decode_with_alloc((const uint8_t *) enc, 8, &len);
+    CU_ASSERT_FATAL(NULL != raw);
+    CU_ASSERT(1 == len && 'f' == raw[0]);
+    free(raw);
+    free(enc);
+
+    len = 99;
+    CU_ASSERT(NULL == b32_decode_with_alloc((const uint8_t *) "MY1=====", 8, &len));
+    CU_ASSERT(0 == len);
+    CU_ASSERT(NULL == b32hex_decode_with_alloc((const uint8_t *) "CO", 2, NULL));
+    CU_ASSERT(NULL == b32_encode_with_alloc((const uint8_t *) "", 0, &len));
+
+    /* Lengths whose encoded size doesn't fit are rejected up front. */
+    CU_ASSERT(SIZE_MAX - 7 == b32_get_encoded_buffer_size_checked(B32_MAX_ENCODE_LEN, &over));
+    CU_ASSERT(0 == over);
+    CU_ASSERT(0 == b32_get_encoded_buffer_size_checked(B32_MAX_ENCODE_LEN + 1, &over));
+    CU_ASSERT(1 == over);
+    CU_ASSERT(NULL
+              == b32_encode_with_alloc((const uint8_t *) "foob", B32_MAX_ENCODE_LEN + 1, &len));
+    CU_ASSERT(NULL == b32hex_encode_with_alloc((const uint8_t *) "foob", SIZE_MAX, &len));
+    CU_ASSERT(0 == b32_encode_append(&buf, (const uint8_t *) "foob", B32_MAX_ENCODE_LEN + 1));
+
+    CU_ASSERT(8 == b32_encode_append(&buf, (const uint8_t *) "fooba", 5));
+    CU_ASSERT(8 == b32hex_encode_append(&buf, (const uint8_t *) "f", 1));
+    CU_ASSERT(1 == b32_decode_append(&buf, (const uint8_t *) "FY", 2));
+    CU_ASSERT(1 == b32hex_decode_append(&buf, (const uint8_t *) "5O======", 8));
+    CU_ASSERT(0 == b32_decode_append(&buf, (const uint8_t *) "F1", 2));
+    CU_ASSERT(0 == b32hex_decode_append(NULL, (const uint8_t *) "5O", 2));
+    CU_ASSERT_FATAL(18 == buf.len);
+    CU_ASSERT(0 == memcmp(buf.data, "MZXW6YTBCO======..", 18));
+    free(buf.data);
+}
+
+void add_suites(CU_pSuite *suite)
+{
+    *suite = CU_add_suite("Base32 tests", NULL, NULL);
+    CU_add_test(*suite, "Test vectors              ", test_vectors);
+    CU_add_test(*suite, "Test round trip           ", test_round_trip);
+    CU_add_test(*suite, "Test errors               ", test_errors);
+    CU_add_test(*suite, "Test alloc and append     ", test_alloc_append);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             External Functions                             */
+/*----------------------------------------------------------------------------*/
+int main(void)
+{
+    unsigned rv     = 1;
+    CU_pSuite suite = NULL;
+
+    if (CUE_SUCCESS == CU_initialize_registry()) {
+        add_suites(&suite);
+
+        if (NULL != suite) {
+            CU_basic_set_mode(CU_BRM_VERBOSE);
+            CU_basic_run_tests();
+            printf("\n");
+            CU_basic_show_failures(CU_get_failure_list());
+            printf("\n\n");
+            rv = CU_get_number_of_tests_failed();
+        }
+
+        CU_cleanup_registry();
+    }
+
+    if (0 != rv) {
+        return 1;
+    }
+    return 0;
+}
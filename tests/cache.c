@@ -0,0 +1,307 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+#include <CUnit/Basic.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/trower-base64/base64.h"
+#include "../include/trower-base64/cache.h"
+
+void test_create(void)
+{
+    CU_ASSERT(NULL == b64_cache_create(0, 16));
+    CU_ASSERT(NULL == b64_cache_create(16, 0));
+    CU_ASSERT(NULL == b64_cache_create(SIZE_MAX, 16));
+    CU_ASSERT(NULL == b64_cache_create(16, SIZE_MAX));
+    b64_cache_destroy(NULL);
+}
+
+void test_lookups(void)
+{
+    b64_cache_t *cache = b64_cache_create(4, 8);
+    const uint8_t mac[] = { 0x00, 0x1a, 0x2b, 0x3c, 0x4d, 0x5e };
+    b64_cache_stats_t s;
+    const char *a, *b, *u;
+    size_t len = 99;
+
+    CU_ASSERT_FATAL(NULL != cache);
+
+    a = b64_cache_encode(cache, mac, sizeof(mac), &len);
+    CU_ASSERT_FATAL(NULL != a);
+    CU_ASSERT(8 == len);
+    CU_ASSERT(0 == strcmp(a, "ABorPE1e"));
+
+    /* The same pointer every time. */
+    b = b64_cache_encode(cache, mac, sizeof(mac), NULL);
+    CU_ASSERT(a == b);
+
+    /* The alphabets are cached separately. */
+    u = b64url_cache_encode(cache, (const uint8_t *) "\xfb\xff", 2, &len);
+    CU_ASSERT_FATAL(NULL != u);
+    CU_ASSERT(3 == len);
+    CU_ASSERT(0 == strcmp(u, "-_8"));
+    a = b64_cache_encode(cache, (const uint8_t *) "\xfb\xff", 2, &len);
+    CU_ASSERT_FATAL(NULL != a);
+    CU_ASSERT(4 == len);
+    CU_ASSERT(0 == strcmp(a, "+/8="));
+    CU_ASSERT(u == b64url_cache_encode(cache, (const uint8_t *) "\xfb\xff", 2, NULL));
+
+    /* Too long, empty or missing inputs are never cached. */
+    CU_ASSERT(NULL == b64_cache_encode(cache, (const uint8_t *) "123456789", 9, &len));
+    CU_ASSERT(0 == len);
+    CU_ASSERT(NULL == b64_cache_encode(cache, mac, 0, &len));
+    CU_ASSERT(NULL == b64_cache_encode(cache, NULL, 3, &len));
+    CU_ASSERT(NULL == b64_cache_encode(NULL, mac, 3, &len));
+
+    /* Once full, new values are turned away but old ones still hit. */
+    CU_ASSERT(NULL != b64_cache_encode(cache, (const uint8_t *) "Man", 3, NULL));
+    CU_ASSERT(NULL == b64_cache_encode(cache, (const uint8_t *) "Woman", 5, NULL));
+    CU_ASSERT(b == b64_cache_encode(cache, mac, sizeof(mac), NULL));
+
+    b64_cache_get_stats(cache, &s);
+    CU_ASSERT(3 == s.hits);
+    CU_ASSERT(5 == s.misses);
+    CU_ASSERT(1 == s.rejected);
+    CU_ASSERT(4 == s.entries);
+    CU_ASSERT(4 == s.capacity);
+
+    b64_cache_get_stats(NULL, &s);
+    CU_ASSERT(0 == s.capacity);
+    b64_cache_get_stats(cache, NULL);
+
+    b64_cache_destroy(cache);
+}
+
+void test_collisions(void)
+{
+    b64_cache_t *cache = b64_cache_create(1000, 4);
+    const char *first[1000];
+    b64_cache_stats_t s;
+    uint8_t enc[8];
+
+    CU_ASSERT_FATAL(NULL != cache);
+
+    /* Fill the cache to capacity and check every value twice. */
+    for (int pass = 0; pass < 2; pass++) {
+        for (uint32_t i = 0; i < 1000; i++) {
+            uint8_t raw[4] = { (uint8_t) i, (uint8_t) (i >> 8), 0, 0 };
+            const char *p  = b64_cache_encode(cache, raw, 2 + (i & 1), NULL);
+
+            CU_ASSERT_FATAL(NULL != p);
+            b64_encode(raw, 2 + (i & 1), enc);
+            CU_ASSERT(0 == memcmp(p, enc, 4));
+            if (0 == pass) {
+                first[i] = p;
+            } else {
+                CU_ASSERT(first[i] == p);
+            }
+        }
+    }
+
+    b64_cache_destroy(cache);
+
+    /* Keys of up to 8 bytes are told apart by their hash alone, so every
+     * byte of them must count; longer ones are compared. */
+    cache = b64_cache_create(200, 12);
+    CU_ASSERT_FATAL(NULL != cache);
+    for (int pass = 0; pass < 2; pass++) {
+        for (size_t len = 1; len <= 12; len++) {
+            for (size_t j = 0; j < len; j++) {
+                uint8_t raw[12] = { 0 };
+                char expect[17];
+                const char *p;
+
+                raw[j] = 0x80;
+                p      = b64_cache_encode(cache, raw, len, NULL);
+                CU_ASSERT_FATAL(NULL != p);
+                b64_encode(raw, len, (uint8_t *) expect);
+                expect[b64_get_encoded_buffer_size(len)] = '\0';
+                CU_ASSERT(0 == strcmp(p, expect));
+            }
+        }
+    }
+    b64_cache_get_stats(cache, &s);
+    CU_ASSERT(78 == s.entries);
+    CU_ASSERT(78 == s.misses);
+
+    b64_cache_destroy(cache);
+}
+
+#define THREADS 4
+#define VALUES  256
+
+struct work {
+    b64_cache_t *cache;
+    const char *seen[VALUES];
+};
+
+static void *worker(void *arg)
+{
+    struct work *w = arg;
+
+    for (int round = 0; round < 20; round++) {
+        for (uint32_t i = 0; i < VALUES; i++) {
+            uint8_t raw[4] = { 'k', (uint8_t) i, (uint8_t) round, 0 };
+
+            /* Half the values are shared by every thread. */
+            if (i & 1) {
+                raw[2] = 0;
+            }
+            w->seen[i] = b64_cache_encode(w->cache, raw, sizeof(raw), NULL);
+        }
+    }
+    return NULL;
+}
+
+void test_threads(void)
+{
+    b64_cache_t *cache = b64_cache_create(THREADS * VALUES * 20, 4);
+    struct work w[THREADS];
+    pthread_t t[THREADS];
+    b64_cache_stats_t s;
+
+    CU_ASSERT_FATAL(NULL != cache);
+
+    for (int i = 0; i < THREADS; i++) {
+        w[i].cache = cache;
+        CU_ASSERT_FATAL(0 == pthread_create(&t[i], NULL, worker, &w[i]));
+    }
+    for (int i = 0; i < THREADS; i++) {
+        pthread_join(t[i], NULL);
+    }
+
+    /* Every thread got the one published copy of each shared value. */
+    for (int i = 1; i < THREADS; i++) {
+        for (int v = 1; v < VALUES; v += 2) {
+            CU_ASSERT(w[0].seen[v] == w[i].seen[v]);
+        }
+    }
+
+    b64_cache_get_stats(cache, &s);
+    CU_ASSERT(THREADS * VALUES * 20 == s.hits + s.misses);
+    CU_ASSERT(0 == s.rejected);
+    CU_ASSERT(VALUES / 2 * 20 + VALUES / 2 == s.entries);
+
+    b64_cache_destroy(cache);
+}
+
+struct hot {
+    b64_cache_t *cache;
+    const char *first;
+    int same;
+};
+
+static void *hot_worker(void *arg)
+{
+    struct hot *h = arg;
+
+    h->first = b64_cache_encode(h->cache, (const uint8_t *) "hot", 3, NULL);
+    for (int i = 1; i < 10000; i++) {
+        h->same += (h->first == b64_cache_encode(h->cache, (const uint8_t *) "hot", 3, NULL));
+    }
+    return NULL;
+}
+
+void test_hot_key(void)
+{
+    b64_cache_t *cache = b64_cache_create(4, 4);
+    struct hot h[THREADS];
+    pthread_t t[THREADS];
+    b64_cache_stats_t s;
+
+    CU_ASSERT_FATAL(NULL != cache);
+
+    /* Every thread hammering one key is the case hits must not contend on. */
+    memset(h, 0, sizeof(h));
+    for (int i = 0; i < THREADS; i++) {
+        h[i].cache = cache;
+        CU_ASSERT_FATAL(0 == pthread_create(&t[i], NULL, hot_worker, &h[i]));
+    }
+    for (int i = 0; i < THREADS; i++) {
+        pthread_join(t[i], NULL);
+    }
+
+    for (int i = 0; i < THREADS; i++) {
+        CU_ASSERT(h[0].first == h[i].first);
+        CU_ASSERT(9999 == h[i].same);
+    }
+    CU_ASSERT(0 == strcmp(h[0].first, "aG90"));
+
+    b64_cache_get_stats(cache, &s);
+    CU_ASSERT(1 <= s.misses);
+    CU_ASSERT(THREADS * 10000 == s.hits + s.misses);
+    CU_ASSERT(1 == s.entries);
+
+    b64_cache_destroy(cache);
+}
+
+void test_thread_churn(void)
+{
+    b64_cache_t *cache = b64_cache_create(4, 4);
+    struct hot h[THREADS];
+    pthread_t t[THREADS];
+    b64_cache_stats_t s;
+
+    CU_ASSERT_FATAL(NULL != cache);
+
+    /* Far more threads than there are owned stripes come and go; the counts
+     * of the exited ones stay with their stripes for the next. */
+    for (int round = 0; round < 50; round++) {
+        memset(h, 0, sizeof(h));
+        for (int i = 0; i < THREADS; i++) {
+            h[i].cache = cache;
+            CU_ASSERT_FATAL(0 == pthread_create(&t[i], NULL, hot_worker, &h[i]));
+        }
+        for (int i = 0; i < THREADS; i++) {
+            pthread_join(t[i], NULL);
+        }
+    }
+
+    b64_cache_get_stats(cache, &s);
+    CU_ASSERT(50 * THREADS * 10000 == s.hits + s.misses);
+    CU_ASSERT(1 <= s.misses);
+
+    b64_cache_destroy(cache);
+}
+
+void add_suites(CU_pSuite *suite)
+{
+    *suite = CU_add_suite("Base64 encode cache tests", NULL, NULL);
+    CU_add_test(*suite, "Test create               ", test_create);
+    CU_add_test(*suite, "Test lookups              ", test_lookups);
+    CU_add_test(*suite, "Test collisions           ", test_collisions);
+    CU_add_test(*suite, "Test threads              ", test_threads);
+    CU_add_test(*suite, "Test hot key              ", test_hot_key);
+    CU_add_test(*suite, "Test thread churn         ", test_thread_churn);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             External Functions                             */
+/*----------------------------------------------------------------------------*/
+int main(void)
+{
+    unsigned rv     = 1;
+    CU_pSuite suite = NULL;
+
+    if (CUE_SUCCESS == CU_initialize_registry()) {
+        add_suites(&suite);
+
+        if (NULL != suite) {
+            CU_basic_set_mode(CU_BRM_VERBOSE);
+            CU_basic_run_tests();
+            printf("\n");
+            CU_basic_show_failures(CU_get_failure_list());
+            printf("\n\n");
+            rv = CU_get_number_of_tests_failed();
+        }
+
+        CU_cleanup_registry();
+    }
+
+    if (0 != rv) {
+        return 1;
+    }
+    return 0;
+}
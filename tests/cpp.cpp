@@ -0,0 +1,179 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+#include <CUnit/Basic.h>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "../include/trower-base64/base64.hpp"
+
+namespace b64 = trower::base64;
+using b64::alphabet;
+
+/* Everything below must be computable by the compiler. */
+static_assert(b64::encoded_size(0) == 0, "");
+static_assert(b64::encoded_size(1) == 4, "");
+static_assert(b64::encoded_size(300) == 400, "");
+static_assert(b64::encoded_size<alphabet::url>(1) == 2, "");
+static_assert(b64::encoded_size<alphabet::url>(8) == 11, "");
+static_assert(b64::decoded_size(3) == 0, "");
+static_assert(b64::decoded_size(8) == 6, "");
+static_assert(b64::decoded_size<alphabet::url>(5) == 0, "");
+static_assert(b64::decoded_size<alphabet::url>(7) == 5, "");
+
+constexpr auto man     = b64::encode_literal("Man");
+constexpr auto leasure = b64::encode_literal("leasure.");
+constexpr auto url     = b64::encode_literal<alphabet::url>("easure.");
+static_assert(man[0] == 'T' && man[1] == 'W' && man[2] == 'F' && man[3] == 'u' && man[4] == '\0', "");
+static_assert(leasure[9] == 'S' && leasure[10] == '4' && leasure[11] == '=' && leasure[12] == '\0', "");
+static_assert(url.size() == 11 && url[9] == 'g' && url[10] == '\0', "");
+
+constexpr auto key = b64::decode_literal("ZWFzdXJlLg==");
+constexpr auto bad = b64::decode_literal("YXN=cmUu");
+constexpr auto sym = b64::decode_literal<alphabet::url>("-_-_");
+static_assert(key.size == 7 && key.data[0] == 'e' && key.data[6] == '.', "");
+static_assert(bad.size == 0, "");
+static_assert(sym.size == 3 && sym.data[0] == 0xfb && sym.data[1] == 0xff && sym.data[2] == 0xbf, "");
+constexpr auto short_pad = b64::decode_literal<alphabet::url>("QQ=");
+static_assert(short_pad.size == 0, "");
+
+void test_constexpr_matches_c()
+{
+    uint8_t raw[64];
+    char ce[128];
+    uint8_t c[128];
+
+    for (size_t i = 0; i < sizeof(raw); i++) {
+        raw[i] = (uint8_t) (i * 37 + 11);
+    }
+
+    for (size_t len = 0; len <= sizeof(raw); len++) {
+        size_t n = b64::detail::encode<alphabet::standard>(raw, len, ce);
+        b64_encode(raw, len, c);
+        CU_ASSERT_EQUAL(n, b64_get_encoded_buffer_size(len));
+        CU_ASSERT(0 == memcmp(ce, c, n));
+
+        n = b64::detail::encode<alphabet::url>(raw, len, ce);
+        b64url_encode(raw, len, c);
+        CU_ASSERT_EQUAL(n, b64url_get_encoded_buffer_size(len));
+        CU_ASSERT(0 == memcmp(ce, c, n));
+
+        uint8_t back[64];
+        CU_ASSERT_EQUAL(len, b64::detail::decode<alphabet::url>(ce, n, back));
+        CU_ASSERT(0 == memcmp(back, raw, len));
+    }
+
+    /* Padding is judged the same way at compile time and at run time. */
+    const char *padded[] = { "QQ=", "QQ==", "Q===", "QUI=", "QUI", "QQ", "=", "==", "====" };
+    for (const char *p : padded) {
+        size_t len = strlen(p);
+        uint8_t ce_out[4];
+        uint8_t c_out[4];
+
+        size_t n = b64::detail::decode<alphabet::standard>(p, len, ce_out);
+        CU_ASSERT_EQUAL(n, b64_decode((const uint8_t *) p, len, c_out));
+        CU_ASSERT(0 == memcmp(ce_out, c_out, n));
+
+        n = b64::detail::decode<alphabet::url>(p, len, ce_out);
+        CU_ASSERT_EQUAL(n, b64url_decode((const uint8_t *) p, len, c_out));
+        CU_ASSERT(0 == memcmp(ce_out, c_out, n));
+    }
+}
+
+void test_string_api()
+{
+    std::string s = b64::encode("leasure.");
+    CU_ASSERT(s == "bGVhc3VyZS4=");
+
+    s = "prefix:";
+    b64::encode_append<alphabet::url>(s, "easure.");
+    CU_ASSERT(s == "prefix:ZWFzdXJlLg");
+
+    b64::encode_append(s, "");
+    CU_ASSERT(s == "prefix:ZWFzdXJlLg");
+
+    std::string out = "x";
+    CU_ASSERT(b64::decode_append(out, "c3VyZS4="));
+    CU_ASSERT(out == "xsure.");
+
+    CU_ASSERT(!b64::decode_append(out, "YXN=cmUu"));
+    CU_ASSERT(out == "xsure.");
+
+    CU_ASSERT(!b64::decode_append(out, "abc"));
+
+    /* Only the length is looked at before throwing. */
+    bool threw = false;
+    try {
+        b64::encode_append(out, std::string_view(out.data(), B64_MAX_ENCODE_LEN + 1));
+    } catch (const std::length_error &) {
+        threw = true;
+    }
+    CU_ASSERT(threw);
+    CU_ASSERT(out == "xsure.");
+
+    CU_ASSERT(b64::decode_append<alphabet::url>(out, "TQ"));
+    CU_ASSERT(out == "xsure.M");
+}
+
+void test_buffer_api()
+{
+    const uint8_t raw[] = { 'M', 'a', 'n' };
+    char enc[4];
+    uint8_t dec[3];
+
+    CU_ASSERT_EQUAL(0, b64::encode(raw, 3, enc, 3));
+    CU_ASSERT_EQUAL(0, b64::encode(raw, B64_MAX_ENCODE_LEN + 1, enc, SIZE_MAX));
+    CU_ASSERT_EQUAL(4, b64::encode(raw, 3, enc, sizeof(enc)));
+    CU_ASSERT(0 == memcmp(enc, "TWFu", 4));
+
+    CU_ASSERT_EQUAL(0, b64::decode("TWFu", dec, 2));
+    CU_ASSERT_EQUAL(3, b64::decode("TWFu", dec, sizeof(dec)));
+    CU_ASSERT(0 == memcmp(dec, raw, 3));
+
+    CU_ASSERT_EQUAL(4, b64::encode_to(raw, 3, enc));
+    CU_ASSERT_EQUAL(3, b64::decode_to(enc, 4, dec));
+    CU_ASSERT(0 == memcmp(dec, raw, 3));
+
+#if defined(__cpp_lib_span)
+    CU_ASSERT_EQUAL(4, b64::encode(std::span<const uint8_t>(raw), std::span<char>(enc)));
+    CU_ASSERT_EQUAL(3, b64::decode("TWFu", std::span<uint8_t>(dec)));
+#endif
+}
+
+void add_suites(CU_pSuite *suite)
+{
+    *suite = CU_add_suite("Base64 C++ tests", NULL, NULL);
+    CU_add_test(*suite, "Test constexpr vs C codec  ", test_constexpr_matches_c);
+    CU_add_test(*suite, "Test std::string API       ", test_string_api);
+    CU_add_test(*suite, "Test buffer API            ", test_buffer_api);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             External Functions                             */
+/*----------------------------------------------------------------------------*/
+int main(void)
+{
+    unsigned rv     = 1;
+    CU_pSuite suite = NULL;
+
+    if (CUE_SUCCESS == CU_initialize_registry()) {
+        add_suites(&suite);
+
+        if (NULL != suite) {
+            CU_basic_set_mode(CU_BRM_VERBOSE);
+            CU_basic_run_tests();
+            printf("\n");
+            CU_basic_show_failures(CU_get_failure_list());
+            printf("\n\n");
+            rv = CU_get_number_of_tests_failed();
+        }
+
+        CU_cleanup_registry();
+    }
+
+    if (0 != rv) {
+        return 1;
+    }
+    return 0;
+}
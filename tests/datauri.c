@@ -0,0 +1,184 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+#include <CUnit/Basic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/trower-base64/base64.h"
+#include "../include/trower-base64/datauri.h"
+
+static size_t parse(const char *uri, b64_data_uri_t *out)
+{
+    return b64_data_uri_parse(uri, strlen(uri), out);
+}
+
+void test_parse(void)
+{
+    const char *uri = "data:image/png;name=x.png;base64,iVBORw0KGgo=";
+    b64_data_uri_t d;
+    uint8_t out[16];
+
+    CU_ASSERT(8 == parse(uri, &d));
+    CU_ASSERT(&uri[5] == d.mime);
+    CU_ASSERT(20 == d.mime_len);
+    CU_ASSERT(0 == strncmp(d.mime, "image/png;name=x.png", d.mime_len));
+    CU_ASSERT(&uri[33] == d.payload);
+    CU_ASSERT(12 == d.payload_len);
+    CU_ASSERT(8 == b64_data_uri_decode(&d, out));
+    CU_ASSERT(0 == memcmp(out, "\x89PNG\r\n\x1a\n", 8));
+
+    /* No media type, any case, and no padding. */
+    CU_ASSERT(0 < parse("DATA:;BASE64,Zm9vYg", &d));
+    CU_ASSERT(NULL == d.mime);
+    CU_ASSERT(0 == d.mime_len);
+    CU_ASSERT(4 == b64_data_uri_decode(&d, out));
+    CU_ASSERT(0 == memcmp(out, "foob", 4));
+}
+
+void test_parse_errors(void)
+{
+    const char *bad[] = {
+        "",
+        "data:",
+        "data:,abcd",                  /* not base64 */
+        "data:text/plain,abcd",        /* not base64 */
+        "data:text/plain;base64abcd",  /* no ',' */
+        "data:;base64,",               /* empty payload */
+        "date:;base64,abcd",           /* wrong scheme */
+        "http://x/;base64,abcd",       /* wrong scheme */
+        "data:base64,abcd",            /* no ';' */
+        "data:text/plain;base64;x,abc", /* base64 must be last */
+    };
+    b64_data_uri_t d;
+    uint8_t out[16];
+
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        CU_ASSERT(0 == parse(bad[i], &d));
+        CU_ASSERT(NULL == d.payload);
+        CU_ASSERT(0 == b64_data_uri_decode(&d, out));
+    }
+
+    CU_ASSERT(0 == b64_data_uri_parse(NULL, 10, &d));
+    CU_ASSERT(0 == b64_data_uri_parse("data:;base64,abcd", 17, NULL));
+
+    /* Parsing only checks the final group of the payload, so the rest is
+     * caught by the decode. */
+    CU_ASSERT(0 == parse("data:;base64,ab!d", &d));
+    CU_ASSERT(0 == parse("data:;base64,ab-_", &d));
+    CU_ASSERT(6 == parse("data:;base64,ab!dabcd", &d));
+    CU_ASSERT(0 == b64_data_uri_decode(&d, out));
+    CU_ASSERT(6 == parse("data:;base64,ab-_abcd", &d));
+    CU_ASSERT(0 == b64_data_uri_decode(&d, out));
+    CU_ASSERT(0 == b64_data_uri_decode(NULL, out));
+    CU_ASSERT(0 == b64_data_uri_decode(&d, NULL));
+}
+
+void test_in_place(void)
+{
+    char uri[] = "data:text/plain;charset=utf-8;base64,SGVsbG8sIHdvcmxkIQ==";
+    b64_data_uri_t d;
+    size_t len;
+
+    CU_ASSERT_FATAL(0 < b64_data_uri_parse(uri, strlen(uri), &d));
+    len = b64_data_uri_decode(&d, (uint8_t *) d.payload);
+    CU_ASSERT(13 == len);
+    CU_ASSERT(0 == memcmp(d.payload, "Hello, world!", 13));
+    CU_ASSERT(0 == strncmp(d.mime, "text/plain;charset=utf-8", d.mime_len));
+}
+
+void test_encode(void)
+{
+    const char *expect = "data:text/plain;base64,SGVsbG8h";
+    char out[64];
+    size_t len;
+    char *p;
+
+    CU_ASSERT(31 == b64_data_uri_get_encoded_size(10, 6));
+    CU_ASSERT(31 == b64_data_uri_encode("text/plain", 10, (const uint8_t *) "Hello!", 6, out));
+    CU_ASSERT(0 == memcmp(out, expect, 31));
+
+    CU_ASSERT(17 == b64_data_uri_get_encoded_size(0, 3));
+    CU_ASSERT(17 == b64_data_uri_encode(NULL, 0, (const uint8_t *) "foo", 3, out));
+    CU_ASSERT(0 == memcmp(out, "data:;base64,Zm9v", 17));
+
+    p = b64_data_uri_encode_with_alloc("text/plain", 10, (const uint8_t *) "Hello!", 6, &len);
+    CU_ASSERT_FATAL(NULL != p);
+    CU_ASSERT(31 == len);
+    CU_ASSERT(0 == strcmp(p, expect));
+    free(p);
+
+    /* Errors */
+    CU_ASSERT(0 == b64_data_uri_get_encoded_size(0, 0));
+    CU_ASSERT(0 == b64_data_uri_get_encoded_size(SIZE_MAX, 3));
+    CU_ASSERT(0 == b64_data_uri_get_encoded_size(0, B64_MAX_ENCODE_LEN + 1));
+    CU_ASSERT(0 == b64_data_uri_get_encoded_size(0, SIZE_MAX));
+    CU_ASSERT(0 == b64_data_uri_encode("a,b", 3, (const uint8_t *) "foo", 3, out));
+    CU_ASSERT(0 == b64_data_uri_encode(NULL, 3, (const uint8_t *) "foo", 3, out));
+    CU_ASSERT(0 == b64_data_uri_encode(NULL, 0, NULL, 3, out));
+    CU_ASSERT(0 == b64_data_uri_encode(NULL, 0, (const uint8_t *) "foo", 3, NULL));
+    CU_ASSERT(NULL == b64_data_uri_encode_with_alloc("a,b", 3, (const uint8_t *) "x", 1, &len));
+    CU_ASSERT(0 == len);
+    CU_ASSERT(NULL == b64_data_uri_encode_with_alloc(NULL, 0, NULL, 0, NULL));
+}
+
+void test_round_trip(void)
+{
+    uint8_t raw[100];
+    uint8_t out[100];
+
+    for (size_t i = 0; i < sizeof(raw); i++) {
+        raw[i] = (uint8_t) (i * 53 + 1);
+    }
+
+    for (size_t len = 1; len <= sizeof(raw); len++) {
+        char *uri = b64_data_uri_encode_with_alloc("application/octet-stream", 24, raw, len,
+                                                    NULL);
+        b64_data_uri_t d;
+
+        CU_ASSERT_FATAL(NULL != uri);
+        CU_ASSERT(len <= b64_data_uri_parse(uri, strlen(uri), &d));
+        CU_ASSERT(len == b64_data_uri_decode(&d, out));
+        CU_ASSERT(0 == memcmp(raw, out, len));
+        free(uri);
+    }
+}
+
+void add_suites(CU_pSuite *suite)
+{
+    *suite = CU_add_suite("Base64 data: URI tests", NULL, NULL);
+    CU_add_test(*suite, "Test parse                ", test_parse);
+    CU_add_test(*suite, "Test parse errors         ", test_parse_errors);
+    CU_add_test(*suite, "Test in place             ", test_in_place);
+    CU_add_test(*suite, "Test encode               ", test_encode);
+    CU_add_test(*suite, "Test round trip           ", test_round_trip);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             External Functions                             */
+/*----------------------------------------------------------------------------*/
+int main(void)
+{
+    unsigned rv     = 1;
+    CU_pSuite suite = NULL;
+
+    if (CUE_SUCCESS == CU_initialize_registry()) {
+        add_suites(&suite);
+
+        if (NULL != suite) {
+            CU_basic_set_mode(CU_BRM_VERBOSE);
+            CU_basic_run_tests();
+            printf("\n");
+            CU_basic_show_failures(CU_get_failure_list());
+            printf("\n\n");
+            rv = CU_get_number_of_tests_failed();
+        }
+
+        CU_cleanup_registry();
+    }
+
+    if (0 != rv) {
+        return 1;
+    }
+    return 0;
+}
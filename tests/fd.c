@@ -0,0 +1,358 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+#define _POSIX_C_SOURCE 200809L
+
+#include <CUnit/Basic.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../include/trower-base64/base64.h"
+#include "../include/trower-base64/fd.h"
+
+struct feed {
+    int fd;
+    const uint8_t *data;
+    size_t len;
+};
+
+/* Returns an unlinked temporary file holding the data, positioned at 0. */
+static int file_with(const void *data, size_t len)
+{
+    char name[] = "/tmp/b64-fd-XXXXXX";
+    int fd      = mkstemp(name);
+
+    if (0 <= fd) {
+        unlink(name);
+        if (((ssize_t) len != write(fd, data, len)) || (0 != lseek(fd, 0, SEEK_SET))) {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    return fd;
+}
+
+/* Reads back everything in the file. */
+static uint8_t *file_contents(int fd, size_t *len)
+{
+    off_t size    = lseek(fd, 0, SEEK_END);
+    uint8_t *data = malloc((size_t) size + 1);
+    size_t got    = 0;
+
+    lseek(fd, 0, SEEK_SET);
+    while (data && got < (size_t) size) {
+        ssize_t n = read(fd, &data[got], (size_t) size - got);
+
+        if (n <= 0) {
+            break;
+        }
+        got += (size_t) n;
+    }
+    *len = got;
+
+    return data;
+}
+
+/* Writes the data into a pipe a few bytes at a time, so the reads on the
+ * other end split groups in every possible way. */
+static void *feed_main(void *arg)
+{
+    struct feed *f = arg;
+    size_t step    = 1;
+
+    for (size_t i = 0; i < f->len; i += step, step = step % 7 + 1) {
+        size_t n = (step < f->len - i) ? step : f->len - i;
+
+        if ((ssize_t) n != write(f->fd, &f->data[i], n)) {
+            break;
+        }
+    }
+    close(f->fd);
+
+    return NULL;
+}
+
+static uint8_t *random_bytes(size_t len)
+{
+    uint8_t *p = malloc(len + 1);
+
+    for (size_t i = 0; p && i < len; i++) {
+        p[i] = (uint8_t) rand();
+    }
+
+    return p;
+}
+
+void test_files(void)
+{
+    const size_t sizes[] = { 0, 1, 2, 3, 4, 5, 65537, 196608, 196610, 1048583 };
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        for (unsigned url = 0; url < 2; url++) {
+            size_t len      = sizes[i];
+            uint8_t *raw    = random_bytes(len);
+            size_t enc_len  = url ? b64url_get_encoded_buffer_size(len)
+                                  : b64_get_encoded_buffer_size(len);
+            uint8_t *expect = malloc(enc_len + 1);
+            int in          = file_with(raw, len);
+            int enc         = file_with("", 0);
+            int dec         = file_with("", 0);
+            uint8_t *got;
+            size_t got_len;
+
+            CU_ASSERT_FATAL(raw && expect && (0 <= in) && (0 <= enc) && (0 <= dec));
+            if (url) {
+                b64url_encode(raw, len, expect);
+            } else {
+                b64_encode(raw, len, expect);
+            }
+
+            CU_ASSERT(0 == b64_encode_fd(in, enc, url ? B64_ENCODE_URL : B64_ENCODE_STANDARD));
+            got = file_contents(enc, &got_len);
+            CU_ASSERT(enc_len == got_len);
+            CU_ASSERT(0 == memcmp(expect, got, enc_len));
+            free(got);
+
+            lseek(enc, 0, SEEK_SET);
+            CU_ASSERT(0 == b64_decode_fd(enc, dec, url ? B64_DECODE_URL : B64_DECODE_STANDARD));
+            got = file_contents(dec, &got_len);
+            CU_ASSERT(len == got_len);
+            CU_ASSERT(0 == memcmp(raw, got, len));
+            free(got);
+
+            close(in);
+            close(enc);
+            close(dec);
+            free(expect);
+            free(raw);
+        }
+    }
+}
+
+void test_pipes(void)
+{
+    size_t len    = 100003;
+    uint8_t *raw  = random_bytes(len);
+    uint8_t *text = malloc(b64_get_encoded_buffer_size(len));
+    struct feed f = { .data = raw, .len = len };
+    int out       = file_with("", 0);
+    pthread_t thread;
+    uint8_t *got;
+    size_t got_len;
+    int fds[2];
+
+    CU_ASSERT_FATAL(raw && text && (0 <= out) && (0 == pipe(fds)));
+    b64_encode(raw, len, text);
+
+    /* Encode from a pipe. */
+    f.fd = fds[1];
+    CU_ASSERT_FATAL(0 == pthread_create(&thread, NULL, feed_main, &f));
+    CU_ASSERT(0 == b64_encode_fd(fds[0], out, B64_ENCODE_STANDARD));
+    pthread_join(thread, NULL);
+    close(fds[0]);
+
+    got = file_contents(out, &got_len);
+    CU_ASSERT(b64_get_encoded_buffer_size(len) == got_len);
+    CU_ASSERT(0 == memcmp(text, got, got_len));
+    free(got);
+
+    /* Decode from a pipe into a pipe. */
+    CU_ASSERT_FATAL(0 == ftruncate(out, 0));
+    lseek(out, 0, SEEK_SET);
+    CU_ASSERT_FATAL(0 == pipe(fds));
+    f.fd   = fds[1];
+    f.data = text;
+    f.len  = b64_get_encoded_buffer_size(len);
+    CU_ASSERT_FATAL(0 == pthread_create(&thread, NULL, feed_main, &f));
+    CU_ASSERT(0 == b64_decode_fd(fds[0], out, B64_DECODE_STANDARD | B64_DECODE_PAD_REQUIRED));
+    pthread_join(thread, NULL);
+    close(fds[0]);
+
+    got = file_contents(out, &got_len);
+    CU_ASSERT(len == got_len);
+    CU_ASSERT(0 == memcmp(raw, got, len));
+    free(got);
+
+    close(out);
+    free(text);
+    free(raw);
+}
+
+void test_decode_errors(void)
+{
+    // clang-format off
+    struct test {
+        const char *in;
+        unsigned flags;
+        int rv;
+    } tests[] = {
+        { "TWFu",         B64_DECODE_PAD_REQUIRED,  0 },
+        { "TWE",          B64_DECODE_PAD_OPTIONAL,  0 },
+        { "TWE=",         B64_DECODE_PAD_OPTIONAL,  0 },
+        { "TWE",          B64_DECODE_PAD_REQUIRED,  -1 },
+        { "TWE=",         B64_DECODE_PAD_FORBIDDEN, -1 },
+        { "TWFuT",        B64_DECODE_PAD_OPTIONAL,  -1 },
+        { "TW!u",         B64_DECODE_PAD_OPTIONAL,  -1 },
+        { "TQ==TWFu",     B64_DECODE_PAD_OPTIONAL,  -1 },
+        { "TQ==TW",       B64_DECODE_PAD_OPTIONAL,  -1 },
+        { "TWFuTWFuTW-u", B64_DECODE_PAD_OPTIONAL,  -1 },
+        { "TWFuTWFuTW-u", B64_DECODE_ANY_ALPHABET,  0 },
+        { "TW\r\nFu\n",   B64_DECODE_PAD_REQUIRED,  0 },
+        { "TQ==\nTWFu\n", B64_DECODE_PAD_OPTIONAL,  -1 },
+        { "TW Fu",        B64_DECODE_PAD_OPTIONAL,  -1 },
+    };
+    // clang-format on
+
+    for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+        int in  = file_with(tests[i].in, strlen(tests[i].in));
+        int out = file_with("", 0);
+
+        errno = 0;
+        CU_ASSERT(tests[i].rv == b64_decode_fd(in, out, tests[i].flags));
+        CU_ASSERT((0 == tests[i].rv) || (EINVAL == errno));
+        close(in);
+        close(out);
+    }
+}
+
+void test_io_errors(void)
+{
+    int out = file_with("", 0);
+    int in  = file_with("abc", 3);
+    int fds[2];
+
+    errno = 0;
+    CU_ASSERT(-1 == b64_encode_fd(-1, out, 0));
+    CU_ASSERT(EBADF == errno);
+    CU_ASSERT(-1 == b64_decode_fd(out, -1, 0));
+
+    /* Writing to the read end of a pipe fails. */
+    CU_ASSERT_FATAL(0 == pipe(fds));
+    CU_ASSERT(-1 == b64_encode_fd(in, fds[0], 0));
+
+    /* Invalid input is reported without waiting for the writer to finish. */
+    CU_ASSERT(4 == write(fds[1], "!!!!", 4));
+    errno = 0;
+    CU_ASSERT(-1 == b64_decode_fd(fds[0], out, 0));
+    CU_ASSERT(EINVAL == errno);
+
+    close(fds[0]);
+    close(fds[1]);
+    close(in);
+    close(out);
+}
+
+/* Writes the encoding of raw as lines of width characters, each ending in
+ * eol, and returns the length. */
+static size_t wrap(const uint8_t *raw, size_t len, size_t width, const char *eol, uint8_t *text)
+{
+    size_t enc_len = b64_get_encoded_buffer_size(len);
+    uint8_t *enc   = malloc(enc_len + 1);
+    size_t n       = 0;
+
+    b64_encode(raw, len, enc);
+    for (size_t i = 0; i < enc_len; i += width) {
+        size_t k = (width < enc_len - i) ? width : enc_len - i;
+
+        memcpy(&text[n], &enc[i], k);
+        n += k;
+        memcpy(&text[n], eol, strlen(eol));
+        n += strlen(eol);
+    }
+    free(enc);
+
+    return n;
+}
+
+void test_wrapped(void)
+{
+    const size_t widths[] = { 1, 3, 64, 76, 1000 };
+    size_t len            = 300007;
+    uint8_t *raw          = random_bytes(len);
+    uint8_t *text         = malloc(b64_get_encoded_buffer_size(len) * 3);
+
+    CU_ASSERT_FATAL(raw && text);
+
+    /* Line breaks anywhere, LF or CRLF, from a file or a pipe. */
+    for (size_t i = 0; i < sizeof(widths) / sizeof(widths[0]); i++) {
+        for (int crlf = 0; crlf < 2; crlf++) {
+            size_t text_len = wrap(raw, len, widths[i], crlf ? "\r\n" : "\n", text);
+            struct feed f   = { .data = text, .len = text_len };
+            int in          = file_with(text, text_len);
+            int out         = file_with("", 0);
+            pthread_t thread;
+            uint8_t *got;
+            size_t got_len;
+            int fds[2];
+
+            CU_ASSERT_FATAL((0 <= in) && (0 <= out));
+            CU_ASSERT(0 == b64_decode_fd(in, out, B64_DECODE_PAD_REQUIRED));
+            got = file_contents(out, &got_len);
+            CU_ASSERT(len == got_len);
+            CU_ASSERT(0 == memcmp(raw, got, len));
+            free(got);
+
+            CU_ASSERT_FATAL(0 == ftruncate(out, 0));
+            lseek(out, 0, SEEK_SET);
+            CU_ASSERT_FATAL(0 == pipe(fds));
+            f.fd = fds[1];
+            CU_ASSERT_FATAL(0 == pthread_create(&thread, NULL, feed_main, &f));
+            CU_ASSERT(0 == b64_decode_fd(fds[0], out, B64_DECODE_PAD_REQUIRED));
+            pthread_join(thread, NULL);
+            close(fds[0]);
+            got = file_contents(out, &got_len);
+            CU_ASSERT(len == got_len);
+            CU_ASSERT(0 == memcmp(raw, got, len));
+            free(got);
+
+            close(in);
+            close(out);
+        }
+    }
+
+    free(text);
+    free(raw);
+}
+
+void add_suites(CU_pSuite *suite)
+{
+    *suite = CU_add_suite("fd stream tests", NULL, NULL);
+    CU_add_test(*suite, "Test files                ", test_files);
+    CU_add_test(*suite, "Test pipes                ", test_pipes);
+    CU_add_test(*suite, "Test wrapped lines        ", test_wrapped);
+    CU_add_test(*suite, "Test decode errors        ", test_decode_errors);
+    CU_add_test(*suite, "Test I/O errors           ", test_io_errors);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             External Functions                             */
+/*----------------------------------------------------------------------------*/
+int main(void)
+{
+    unsigned rv     = 1;
+    CU_pSuite suite = NULL;
+
+    if (CUE_SUCCESS == CU_initialize_registry()) {
+        add_suites(&suite);
+
+        if (NULL != suite) {
+            CU_basic_set_mode(CU_BRM_VERBOSE);
+            CU_basic_run_tests();
+            printf("\n");
+            CU_basic_show_failures(CU_get_failure_list());
+            printf("\n\n");
+            rv = CU_get_number_of_tests_failed();
+        }
+
+        CU_cleanup_registry();
+    }
+
+    if (0 != rv) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,206 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+#include <CUnit/Basic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/trower-base64/base64.h"
+#include "../include/trower-base64/pem.h"
+
+static size_t decode(const char *text, b64_pem_t *pem)
+{
+    return b64_pem_decode((const uint8_t *) text, strlen(text), pem);
+}
+
+void test_simple(void)
+{
+    b64_pem_t pem;
+    const char *text = "Subject: example\n"
+                       "-----BEGIN CERTIFICATE-----\n"
+                       "SGVsbG8s\n"
+                       "IHdvcmxk\n"
+                       "IQ==\n"
+                       "-----END CERTIFICATE-----\n"
+                       "\n"
+                       "# A comment between blocks\n"
+                       "-----BEGIN X509 CRL-----\r\n"
+                       "Zm9v   \r\n"
+                       "-----END X509 CRL-----";
+
+    CU_ASSERT_FATAL(2 == decode(text, &pem));
+    CU_ASSERT(2 == pem.count);
+
+    CU_ASSERT(0 == strcmp(pem.entries[0].label, "CERTIFICATE"));
+    CU_ASSERT(13 == pem.entries[0].der_len);
+    CU_ASSERT(0 == memcmp(pem.entries[0].der, "Hello, world!", 13));
+
+    CU_ASSERT(0 == strcmp(pem.entries[1].label, "X509 CRL"));
+    CU_ASSERT(3 == pem.entries[1].der_len);
+    CU_ASSERT(0 == memcmp(pem.entries[1].der, "foo", 3));
+
+    b64_pem_free(&pem);
+    CU_ASSERT(NULL == pem.entries);
+    CU_ASSERT(0 == pem.count);
+    b64_pem_free(&pem);
+    b64_pem_free(NULL);
+}
+
+void test_ragged_lines(void)
+{
+    b64_pem_t pem;
+
+    /* Lines that split the 4 character groups still decode. */
+    CU_ASSERT_FATAL(1 == decode("-----BEGIN A-----\nS\nGVsb\nG8sIHd\nvcmxkIQ\n==\n-----END A-----\n",
+                                &pem));
+    CU_ASSERT(13 == pem.entries[0].der_len);
+    CU_ASSERT(0 == memcmp(pem.entries[0].der, "Hello, world!", 13));
+    b64_pem_free(&pem);
+
+    /* So may the padding. */
+    CU_ASSERT_FATAL(1 == decode("-----BEGIN A-----\nZm9vY\nmE=\n-----END A-----\n", &pem));
+    CU_ASSERT(5 == pem.entries[0].der_len);
+    CU_ASSERT(0 == memcmp(pem.entries[0].der, "fooba", 5));
+    b64_pem_free(&pem);
+
+    CU_ASSERT_FATAL(1 == decode("-----BEGIN A-----\nZg=\n=\n-----END A-----\n", &pem));
+    CU_ASSERT(1 == pem.entries[0].der_len);
+    CU_ASSERT(0 == memcmp(pem.entries[0].der, "f", 1));
+    b64_pem_free(&pem);
+
+    /* An empty body is allowed. */
+    CU_ASSERT_FATAL(1 == decode("-----BEGIN EMPTY-----\n-----END EMPTY-----\n", &pem));
+    CU_ASSERT(0 == pem.entries[0].der_len);
+    b64_pem_free(&pem);
+}
+
+void test_errors(void)
+{
+    const char *bad[] = {
+        "",
+        "no blocks at all\n",
+        "-----BEGIN A-----\nZm9v\n",                             /* no END */
+        "-----BEGIN A-----\nZm9v\n-----END B-----\n",            /* label mismatch */
+        "-----BEGIN A-----\nZm9v\n-----END A----\n",             /* short dashes */
+        "-----BEGIN -----\nZm9v\n-----END -----\n",              /* no label */
+        "-----BEGIN A-----x\nZm9v\n-----END A-----\n",           /* junk after BEGIN */
+        "-----BEGIN A\nZm9v\n-----END A-----\n",                 /* unterminated BEGIN */
+        "-----BEGIN A-----\nZm9\n-----END A-----\n",             /* partial group */
+        "-----BEGIN A-----\n====\n-----END A-----\n",            /* only padding */
+        "-----BEGIN A-----\nZ===\n-----END A-----\n",            /* three pads */
+        "-----BEGIN A-----\nZg==\nZm9v\n-----END A-----\n",      /* data after padding */
+        "-----BEGIN A-----\nZg==Zm9v\n-----END A-----\n",        /* padding mid line */
+        "-----BEGIN A-----\nZm 9v\n-----END A-----\n",           /* inner whitespace */
+        "-----BEGIN A-----\nZm9v\n-----END A-----\n"
+        "-----BEGIN B-----\nZm!v\n-----END B-----\n",            /* any bad block */
+    };
+    const uint8_t nul_label[] = "-----BEGIN A\0B-----\nZm9v\n-----END A\0B-----\n";
+    b64_pem_t pem;
+
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        memset(&pem, 0xff, sizeof(pem));
+        CU_ASSERT(0 == decode(bad[i], &pem));
+        CU_ASSERT(NULL == pem.entries);
+        CU_ASSERT(NULL == pem.arena);
+        CU_ASSERT(0 == pem.count);
+    }
+
+    /* A label with a '\0' in it. */
+    memset(&pem, 0xff, sizeof(pem));
+    CU_ASSERT(0 == b64_pem_decode(nul_label, sizeof(nul_label) - 1, &pem));
+    CU_ASSERT(NULL == pem.arena);
+
+    CU_ASSERT(0 == b64_pem_decode(NULL, 10, &pem));
+    CU_ASSERT(0 == b64_pem_decode((const uint8_t *) "x", 1, NULL));
+}
+
+void test_bundle(void)
+{
+    size_t count = 200;
+    size_t der   = 1000;
+    size_t size  = count * (b64_get_encoded_buffer_size(der) * 65 / 64 + 128);
+    char *text   = malloc(size);
+    uint8_t *raw = malloc(der);
+    char *enc    = malloc(b64_get_encoded_buffer_size(der));
+    size_t used  = 0;
+    b64_pem_t pem;
+
+    CU_ASSERT_FATAL(text && raw && enc);
+
+    /* A bundle of differently sized blocks with the usual 64 column lines. */
+    for (size_t i = 0; i < count; i++) {
+        size_t len = der - i;
+        size_t enc_len;
+
+        for (size_t j = 0; j < len; j++) {
+            raw[j] = (uint8_t) (i * 31 + j);
+        }
+        enc_len = b64_get_encoded_buffer_size(len);
+        b64_encode(raw, len, (uint8_t *) enc);
+
+        used += sprintf(&text[used], "# Block %zu\n-----BEGIN CERTIFICATE-----\n", i);
+        for (size_t j = 0; j < enc_len; j += 64) {
+            size_t n = (64 < enc_len - j) ? 64 : enc_len - j;
+
+            memcpy(&text[used], &enc[j], n);
+            used += n;
+            text[used++] = '\n';
+        }
+        used += sprintf(&text[used], "-----END CERTIFICATE-----\n");
+    }
+
+    CU_ASSERT_FATAL(count == b64_pem_decode((const uint8_t *) text, used, &pem));
+    for (size_t i = 0; i < count; i++) {
+        size_t len = der - i;
+
+        for (size_t j = 0; j < len; j++) {
+            raw[j] = (uint8_t) (i * 31 + j);
+        }
+        CU_ASSERT(len == pem.entries[i].der_len);
+        CU_ASSERT(0 == memcmp(raw, pem.entries[i].der, len));
+        CU_ASSERT(0 == strcmp("CERTIFICATE", pem.entries[i].label));
+    }
+    b64_pem_free(&pem);
+
+    free(text);
+    free(raw);
+    free(enc);
+}
+
+void add_suites(CU_pSuite *suite)
+{
+    *suite = CU_add_suite("Base64 PEM tests", NULL, NULL);
+    CU_add_test(*suite, "Test simple               ", test_simple);
+    CU_add_test(*suite, "Test ragged lines         ", test_ragged_lines);
+    CU_add_test(*suite, "Test errors               ", test_errors);
+    CU_add_test(*suite, "Test bundle               ", test_bundle);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             External Functions                             */
+/*----------------------------------------------------------------------------*/
+int main(void)
+{
+    unsigned rv     = 1;
+    CU_pSuite suite = NULL;
+
+    if (CUE_SUCCESS == CU_initialize_registry()) {
+        add_suites(&suite);
+
+        if (NULL != suite) {
+            CU_basic_set_mode(CU_BRM_VERBOSE);
+            CU_basic_run_tests();
+            printf("\n");
+            CU_basic_show_failures(CU_get_failure_list());
+            printf("\n\n");
+            rv = CU_get_number_of_tests_failed();
+        }
+
+        CU_cleanup_registry();
+    }
+
+    if (0 != rv) {
+        return 1;
+    }
+    return 0;
+}
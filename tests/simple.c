@@ -552,6 +552,731 @@ void test_encode_w_alloc(void)
     test_encode_w_alloc_helper(b64url_encode_with_alloc);
 }
 
+/* Escapes every '/' and every 7th character as \uXXXX, the way some JSON
+ * producers do. */
+static size_t json_escape(const uint8_t *in, size_t len, char *out)
+{
+    size_t j = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        if ('/' == in[i]) {
+            out[j++] = '\\';
+            out[j++] = '/';
+        } else if (0 == (i % 7)) {
+            j += (size_t) sprintf(&out[j], (i & 1) ? "\\u%04x" : "\\u%04X", in[i]);
+        } else {
+            out[j++] = (char) in[i];
+        }
+    }
+
+    return j;
+}
+
+void test_decode_json(void)
+{
+    // clang-format off
+    struct test_vector local[] = {
+        {  4, "TWFu",              3, "Man"           },
+        {  8, "\\/\\/\\/\\/",      3, "\xff\xff\xff"  },
+        {  9, "\\u0054WFu",        3, "Man"           },
+        {  9, "TWE\\u003d",        2, "Ma"            },
+        { 14, "TQ\\u003D\\u003d",  1, "M"             },
+        {  5, "TW\\nu",            0, NULL            },
+        {  6, "TWFu\\u",           0, NULL            },
+        {  7, "TW\\u00u",          0, NULL            },
+        {  9, "TW\\u00e9u",        0, NULL            },
+        {  4, "TW\\x",             0, NULL            },
+        { 13, "TQ==\\u0054WFu",    0, NULL            },
+        {  7, "TW\\u003",          0, NULL            },
+        {  2, "\\/",               0, NULL            },
+    };
+    // clang-format on
+    uint8_t raw[2000];
+    uint8_t enc[2700];
+    char esc[16000];
+    uint8_t out[2000];
+
+    for (size_t i = 0; i < sizeof(local) / sizeof(struct test_vector); i++) {
+        size_t rv = b64_decode_json((const uint8_t *) local[i].in, local[i].in_len, out);
+        CU_ASSERT_EQUAL(local[i].out_len, rv);
+        if (rv == local[i].out_len) {
+            /* Rejected inputs have no expected bytes to compare. */
+            if (0 < rv) {
+                CU_ASSERT(0 == memcmp(out, local[i].out, rv));
+            }
+        } else {
+            printf("json: '%s' expected %zd got %zd\n", local[i].in, local[i].out_len, rv);
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(raw); i++) {
+        raw[i] = (uint8_t) ((i * 7919) >> 3);
+    }
+
+    for (size_t len = 1; len < sizeof(raw); len += 97) {
+        size_t enc_len = b64_get_encoded_buffer_size(len);
+        size_t esc_len;
+
+        b64_encode(raw, len, enc);
+        esc_len = json_escape(enc, enc_len, esc);
+        CU_ASSERT(len == b64_decode_json((uint8_t *) esc, esc_len, out));
+        CU_ASSERT(0 == memcmp(raw, out, len));
+
+        enc_len = b64url_get_encoded_buffer_size(len);
+        b64url_encode(raw, len, enc);
+        esc_len = json_escape(enc, enc_len, esc);
+        CU_ASSERT(len == b64url_decode_json((uint8_t *) esc, esc_len, out));
+        CU_ASSERT(0 == memcmp(raw, out, len));
+
+        /* The std decoder rejects the url alphabet, escaped or not. */
+        if (memchr(esc, '_', esc_len)) {
+            CU_ASSERT(0 == b64_decode_json((uint8_t *) esc, esc_len, out));
+        }
+    }
+
+    /* Long runs of escapes are staged and flushed in blocks. */
+    memset(raw, 0xff, 240);
+    b64_encode(raw, 240, enc);
+    CU_ASSERT(640 == json_escape(enc, 320, esc));
+    CU_ASSERT(240 == b64_decode_json((uint8_t *) esc, 640, out));
+    CU_ASSERT(0 == memcmp(raw, out, 240));
+
+    CU_ASSERT(0 == b64_decode_json(NULL, 4, out));
+    CU_ASSERT(0 == b64_decode_json((const uint8_t *) "TWFu", 4, NULL));
+    CU_ASSERT(0 == b64url_decode_json((const uint8_t *) "T\\u0057", 0, out));
+}
+
+void test_decode_flags(void)
+{
+    // clang-format off
+    struct {
+        unsigned flags;
+        struct test_vector v;
+    } local[] = {
+        { B64_DECODE_STANDARD,                                { 4, "TWE=",     2, "Ma"              } },
+        { B64_DECODE_STANDARD,                                { 3, "TWE",      2, "Ma"              } },
+        { B64_DECODE_STANDARD,                                { 2, "TQ",       1, "M"               } },
+        { B64_DECODE_STANDARD,                                { 3, "TQ=",      0, NULL              } },
+        { B64_DECODE_STANDARD,                                { 5, "TWFub",    0, NULL              } },
+        { B64_DECODE_STANDARD,                                { 4, "-_-_",     0, NULL              } },
+        { B64_DECODE_STANDARD | B64_DECODE_PAD_REQUIRED,      { 3, "TWE",      0, NULL              } },
+        { B64_DECODE_STANDARD | B64_DECODE_PAD_FORBIDDEN,     { 4, "TWE=",     0, NULL              } },
+        { B64_DECODE_STANDARD | B64_DECODE_PAD_FORBIDDEN,     { 4, "TWFu",     3, "Man"             } },
+        { B64_DECODE_URL,                                     { 4, "+/+/",     0, NULL              } },
+        { B64_DECODE_URL | B64_DECODE_PAD_REQUIRED,           { 4, "TQ==",     1, "M"               } },
+        { B64_DECODE_URL | B64_DECODE_PAD_REQUIRED,           { 2, "TQ",       0, NULL              } },
+        { B64_DECODE_URL | B64_DECODE_PAD_FORBIDDEN,          { 4, "TQ==",     0, NULL              } },
+        { B64_DECODE_ANY_ALPHABET,                            { 8, "+/-_-_+/", 6, "\xfb\xff\xbf\xfb\xff\xbf" } },
+        { B64_DECODE_ANY_ALPHABET,                            { 7, "+/-_-_+",  5, "\xfb\xff\xbf\xfb\xff" } },
+        { B64_DECODE_ANY_ALPHABET | B64_DECODE_PAD_REQUIRED,  { 8, "+/-_-_+=", 5, "\xfb\xff\xbf\xfb\xff" } },
+        { B64_DECODE_ANY_ALPHABET,                            { 4, "====",     0, NULL              } },
+        { B64_DECODE_ANY_ALPHABET,                            { 4, "a===",     0, NULL              } },
+        { B64_DECODE_ANY_ALPHABET,                            { 1, "=",        0, NULL              } },
+    };
+    // clang-format on
+    struct test_vector *t = common_decoder_tests;
+    uint8_t out[512];
+    uint8_t *buf;
+    size_t len;
+
+    for (size_t i = 0; i < sizeof(local) / sizeof(local[0]); i++) {
+        struct test_vector *v = &local[i].v;
+        size_t rv             = b64_decode_flags((const uint8_t *) v->in, v->in_len, out, local[i].flags);
+
+        CU_ASSERT_EQUAL(v->out_len, rv);
+        if (rv == v->out_len) {
+            /* Rejected inputs have no expected bytes to compare. */
+            if (0 < rv) {
+                CU_ASSERT(0 == memcmp(out, v->out, rv));
+            }
+        } else {
+            printf("flags 0x%04x: '%s' expected %zd got %zd\n", local[i].flags, v->in, v->out_len, rv);
+        }
+    }
+
+    /* The legacy functions are special cases of the flags. */
+    for (size_t i = 0; i < sizeof(common_decoder_tests) / sizeof(struct test_vector); i++) {
+        if (!t[i].in) {
+            continue;
+        }
+        CU_ASSERT(b64_decode((const uint8_t *) t[i].in, t[i].in_len, out)
+                  == b64_decode_flags((const uint8_t *) t[i].in, t[i].in_len, out,
+                                      B64_DECODE_STANDARD | B64_DECODE_PAD_REQUIRED));
+        CU_ASSERT(b64url_decode((const uint8_t *) t[i].in, t[i].in_len, out)
+                  == b64_decode_flags((const uint8_t *) t[i].in, t[i].in_len, out,
+                                      B64_DECODE_URL | B64_DECODE_PAD_OPTIONAL));
+    }
+
+    for (size_t i = 0; i < 100; i++) {
+        CU_ASSERT(b64_get_decoded_buffer_size(i)
+                  == b64_get_decoded_buffer_size_flags(i, B64_DECODE_PAD_REQUIRED));
+        CU_ASSERT(b64url_get_decoded_buffer_size(i)
+                  == b64_get_decoded_buffer_size_flags(i, B64_DECODE_URL));
+    }
+
+    CU_ASSERT(0 == b64_decode_flags(NULL, 4, out, 0));
+    CU_ASSERT(0 == b64_decode_flags((const uint8_t *) "TWFu", 4, NULL, 0));
+
+    buf = b64_decode_flags_with_alloc((const uint8_t *) "TWE", 3, &len, B64_DECODE_STANDARD);
+    CU_ASSERT_FATAL(NULL != buf);
+    CU_ASSERT(2 == len && 'M' == buf[0] && 'a' == buf[1]);
+    free(buf);
+
+    len = 99;
+    CU_ASSERT(NULL == b64_decode_flags_with_alloc((const uint8_t *) "TWE", 3, &len, B64_DECODE_PAD_REQUIRED));
+    CU_ASSERT(0 == len);
+    CU_ASSERT(NULL == b64_decode_flags_with_alloc((const uint8_t *) "T|E", 3, &len, 0));
+    CU_ASSERT(NULL == b64_decode_flags_with_alloc((const uint8_t *) "TWE", 3, NULL, 0));
+}
+
+void test_utf16(void)
+{
+    struct test_vector *t = common_decoder_tests;
+    uint8_t raw[300];
+    uint8_t enc8[400];
+    uint16_t enc16[400];
+    uint8_t out8[300];
+    uint8_t out16[300];
+
+    for (size_t i = 0; i < sizeof(raw); i++) {
+        raw[i] = (uint8_t) (i * 131 + 7);
+    }
+
+    /* The code units must match the byte codec exactly. */
+    for (size_t len = 0; len <= sizeof(raw); len++) {
+        size_t n = b64_get_encoded_buffer_size(len);
+
+        b64_encode(raw, len, enc8);
+        b64_encode_utf16(raw, len, enc16);
+        for (size_t i = 0; i < n; i++) {
+            CU_ASSERT(enc8[i] == enc16[i]);
+        }
+        if (n) {
+            CU_ASSERT(len == b64_decode_utf16(enc16, n, out16));
+            CU_ASSERT(0 == memcmp(raw, out16, len));
+        }
+
+        n = b64url_get_encoded_buffer_size(len);
+        b64url_encode(raw, len, enc8);
+        b64url_encode_utf16(raw, len, enc16);
+        for (size_t i = 0; i < n; i++) {
+            CU_ASSERT(enc8[i] == enc16[i]);
+        }
+        if (n) {
+            CU_ASSERT(len == b64url_decode_utf16(enc16, n, out16));
+            CU_ASSERT(0 == memcmp(raw, out16, len));
+        }
+    }
+
+    /* Same answers as the byte decoders for all the common vectors. */
+    for (size_t i = 0; i < sizeof(common_decoder_tests) / sizeof(struct test_vector); i++) {
+        size_t len = t[i].in_len;
+        size_t rv8, rv16;
+
+        if (!t[i].in) {
+            continue;
+        }
+        for (size_t k = 0; k < len; k++) {
+            enc16[k] = (uint8_t) t[i].in[k];
+        }
+
+        rv8  = b64_decode((const uint8_t *) t[i].in, len, out8);
+        rv16 = b64_decode_utf16(enc16, len, out16);
+        CU_ASSERT(rv8 == rv16);
+        CU_ASSERT(0 == memcmp(out8, out16, rv8));
+
+        rv8  = b64url_decode((const uint8_t *) t[i].in, len, out8);
+        rv16 = b64url_decode_utf16(enc16, len, out16);
+        CU_ASSERT(rv8 == rv16);
+        CU_ASSERT(0 == memcmp(out8, out16, rv8));
+    }
+
+    /* Code units that narrow to valid characters are still rejected. */
+    enc16[0] = 'T';
+    enc16[1] = 'W';
+    enc16[2] = 'F';
+    enc16[3] = 'u';
+    CU_ASSERT(3 == b64_decode_utf16(enc16, 4, out16));
+    enc16[2] = 0x0100 | 'F';
+    CU_ASSERT(0 == b64_decode_utf16(enc16, 4, out16));
+    enc16[2] = 0xff46;
+    CU_ASSERT(0 == b64url_decode_utf16(enc16, 4, out16));
+    enc16[2] = 0x00e9;
+    CU_ASSERT(0 == b64url_decode_utf16(enc16, 4, out16));
+
+    CU_ASSERT(0 == b64_decode_utf16(NULL, 4, out16));
+    CU_ASSERT(0 == b64_decode_utf16(enc16, 4, NULL));
+    CU_ASSERT(0 == b64url_decode_utf16(NULL, 4, out16));
+}
+
+static size_t realloc_calls = 0;
+
+static void *counting_realloc(void *ptr, size_t size)
+{
+    realloc_calls++;
+    return realloc(ptr, size);
+}
+
+void test_append(void)
+{
+    b64_buf_t buf = { .realloc_fn = counting_realloc };
+    uint8_t fake_buf;
+
+    CU_ASSERT(4 == b64_encode_append(&buf, (const uint8_t *) "Man", 3));
+    CU_ASSERT(1 == realloc_calls);
+    CU_ASSERT(1 == b64_decode_append(&buf, (const uint8_t *) "Lg==", 4));
+    CU_ASSERT(3 == b64url_encode_append(&buf, (const uint8_t *) "e.", 2));
+    CU_ASSERT(3 == b64url_decode_append(&buf, (const uint8_t *) "-_-_", 4));
+    CU_ASSERT_FATAL(11 == buf.len);
+    CU_ASSERT(0 == memcmp(buf.data, "TWFu.ZS4\xfb\xff\xbf", 11));
+
+    /* Errors leave the buffer alone. */
+    CU_ASSERT(0 == b64_decode_append(&buf, (const uint8_t *) "YXN=cmUu", 8));
+    CU_ASSERT(0 == b64url_decode_append(&buf, (const uint8_t *) "bad4=", 5));
+    CU_ASSERT(0 == b64_encode_append(&buf, (const uint8_t *) "", 0));
+    CU_ASSERT(0 == b64_encode_append(&buf, NULL, 3));
+    CU_ASSERT(0 == b64_encode_append(NULL, &fake_buf, 1));
+    CU_ASSERT(0 == b64_decode_append(NULL, &fake_buf, 4));
+    CU_ASSERT(11 == buf.len);
+
+    /* Growth is geometric, so many appends cause few reallocations. */
+    for (int i = 0; i < 1000; i++) {
+        CU_ASSERT(4 == b64_encode_append(&buf, (const uint8_t *) "Man", 3));
+    }
+    CU_ASSERT(4011 == buf.len);
+    CU_ASSERT(realloc_calls < 10);
+    CU_ASSERT(0 == memcmp(&buf.data[4007], "TWFu", 4));
+    free(buf.data);
+
+    /* The default allocator is realloc() */
+    memset(&buf, 0, sizeof(buf));
+    CU_ASSERT(4 == b64_encode_append(&buf, (const uint8_t *) "Man", 3));
+    free(buf.data);
+}
+
+static const char std_alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char url_alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+/* An obviously correct, bit at a time encoder to check the library against. */
+static size_t reference_encode(const char *alphabet, int pad, const uint8_t *in, size_t len,
+                               uint8_t *out)
+{
+    size_t j = 0;
+
+    for (size_t bit = 0; bit < len * 8; bit += 6) {
+        unsigned val = 0;
+
+        for (size_t k = bit; k < bit + 6; k++) {
+            val <<= 1;
+            if (k < len * 8) {
+                val |= 1 & (in[k / 8] >> (7 - (k % 8)));
+            }
+        }
+        out[j++] = (uint8_t) alphabet[val];
+    }
+    while (pad && (0x03 & j)) {
+        out[j++] = '=';
+    }
+
+    return j;
+}
+
+void test_long_inputs(void)
+{
+    static const uint8_t bad[] = { '!', '=', '.', '@', '[', '`', '{', ' ', 0x80, 0xff, 0 };
+    uint8_t raw[200];
+    uint8_t ref[300];
+    uint8_t enc[300];
+    uint8_t dec[200];
+
+    for (size_t i = 0; i < sizeof(raw); i++) {
+        raw[i] = (uint8_t) (i * 167 + 13);
+    }
+
+    for (size_t len = 0; len <= sizeof(raw); len++) {
+        size_t n = reference_encode(std_alphabet, 1, raw, len, ref);
+
+        b64_encode(raw, len, enc);
+        CU_ASSERT(n == b64_get_encoded_buffer_size(len));
+        CU_ASSERT(0 == memcmp(ref, enc, n));
+        if (n) {
+            CU_ASSERT(len == b64_decode(enc, n, dec));
+            CU_ASSERT(0 == memcmp(raw, dec, len));
+        }
+
+        n = reference_encode(url_alphabet, 0, raw, len, ref);
+        b64url_encode(raw, len, enc);
+        CU_ASSERT(n == b64url_get_encoded_buffer_size(len));
+        CU_ASSERT(0 == memcmp(ref, enc, n));
+        if (n) {
+            CU_ASSERT(len == b64url_decode(enc, n, dec));
+            CU_ASSERT(0 == memcmp(raw, dec, len));
+        }
+    }
+
+    /* Every character value in every position of a block. */
+    for (size_t i = 0; i < 64; i++) {
+        uint8_t text[72];
+
+        for (size_t k = 0; k < sizeof(text); k++) {
+            text[k] = (uint8_t) std_alphabet[(i + k * 7) % 64];
+        }
+        CU_ASSERT_FATAL(54 == b64_decode(text, sizeof(text), dec));
+        reference_encode(std_alphabet, 1, dec, 54, enc);
+        CU_ASSERT(0 == memcmp(text, enc, sizeof(text)));
+
+        for (size_t k = 0; k < sizeof(text); k++) {
+            text[k] = (uint8_t) url_alphabet[(i + k * 7) % 64];
+        }
+        CU_ASSERT_FATAL(54 == b64url_decode(text, sizeof(text), dec));
+        reference_encode(url_alphabet, 0, dec, 54, enc);
+        CU_ASSERT(0 == memcmp(text, enc, sizeof(text)));
+    }
+
+    /* A bad character anywhere in a long input is caught. */
+    b64_encode(raw, 150, enc);
+    for (size_t pos = 0; pos < 200; pos++) {
+        for (size_t k = 0; k < sizeof(bad); k++) {
+            uint8_t save = enc[pos];
+
+            /* ... except '=' as the last two characters, which is padding. */
+            if (('=' == bad[k]) && (198 <= pos)) {
+                continue;
+            }
+            enc[pos] = bad[k];
+            CU_ASSERT(0 == b64_decode(enc, 200, dec));
+            enc[pos] = (uint8_t) ((0 == pos % 2) ? '-' : '_');
+            CU_ASSERT(0 == b64_decode(enc, 200, dec));
+            enc[pos] = save;
+        }
+    }
+    CU_ASSERT(150 == b64_decode(enc, 200, dec));
+
+    b64url_encode(raw, 150, enc);
+    for (size_t pos = 0; pos < 200; pos++) {
+        uint8_t save = enc[pos];
+
+        enc[pos] = (uint8_t) ((0 == pos % 2) ? '+' : '/');
+        CU_ASSERT(0 == b64url_decode(enc, 200, dec));
+        CU_ASSERT(150 == b64_decode_flags(enc, 200, dec, B64_DECODE_ANY_ALPHABET));
+        enc[pos] = save;
+    }
+    CU_ASSERT(150 == b64url_decode(enc, 200, dec));
+}
+
+/* Decoding over the encoded text itself, which the data: URI decode relies
+ * on, works for every length with every kernel. */
+void test_decode_in_place(void)
+{
+    uint8_t raw[200];
+    uint8_t buf[300];
+
+    for (size_t i = 0; i < sizeof(raw); i++) {
+        raw[i] = (uint8_t) (i * 89 + 7);
+    }
+
+    for (size_t len = 1; len <= sizeof(raw); len++) {
+        size_t n = b64_get_encoded_buffer_size(len);
+
+        b64_encode(raw, len, buf);
+        CU_ASSERT(len == b64_decode(buf, n, buf));
+        CU_ASSERT(0 == memcmp(raw, buf, len));
+
+        b64url_encode(raw, len, buf);
+        n = b64url_get_encoded_buffer_size(len);
+        CU_ASSERT(len == b64_decode_flags(buf, n, buf, B64_DECODE_URL));
+        CU_ASSERT(0 == memcmp(raw, buf, len));
+    }
+}
+
+void test_decoded_size_exact(void)
+{
+    uint8_t raw[200];
+    uint8_t buf[300];
+    uint8_t out[200];
+    int needs;
+
+    for (size_t i = 0; i < sizeof(raw); i++) {
+        raw[i] = (uint8_t) (i * 53 + 11);
+    }
+
+    for (size_t len = 1; len <= sizeof(raw); len++) {
+        size_t n = b64_get_encoded_buffer_size(len);
+
+        b64_encode(raw, len, buf);
+        needs = 99;
+        CU_ASSERT(len == b64_get_decoded_size(buf, n, &needs));
+        CU_ASSERT((4 < n) == needs);
+        CU_ASSERT(len == b64_decode(buf, n, out));
+        CU_ASSERT(len == b64_get_decoded_size_flags(buf, n, B64_DECODE_STANDARD, NULL));
+
+        b64url_encode(raw, len, buf);
+        n = b64url_get_encoded_buffer_size(len);
+        needs = 99;
+        CU_ASSERT(len == b64url_get_decoded_size(buf, n, &needs));
+        CU_ASSERT((4 < n) == needs);
+        CU_ASSERT(len == b64url_decode(buf, n, out));
+        CU_ASSERT(len == b64_get_decoded_size_flags(buf, n, B64_DECODE_URL, NULL));
+        if (0 != n % 4) {
+            CU_ASSERT(0 == b64_get_decoded_size(buf, n, NULL));
+        }
+    }
+
+    /* Only the final group is checked. */
+    CU_ASSERT(6 == b64_get_decoded_size((const uint8_t *) "TW|uTWFu", 8, &needs));
+    CU_ASSERT(1 == needs);
+    CU_ASSERT(0 == b64_decode((const uint8_t *) "TW|uTWFu", 8, out));
+    CU_ASSERT(0 == b64_get_decoded_size((const uint8_t *) "TWFuTW|u", 8, &needs));
+    CU_ASSERT(0 == needs);
+
+    CU_ASSERT(1 == b64_get_decoded_size((const uint8_t *) "TQ==", 4, NULL));
+    CU_ASSERT(2 == b64_get_decoded_size((const uint8_t *) "TWE=", 4, NULL));
+    CU_ASSERT(0 == b64_get_decoded_size((const uint8_t *) "====", 4, NULL));
+    CU_ASSERT(0 == b64_get_decoded_size((const uint8_t *) "TWE", 3, NULL));
+    CU_ASSERT(0 == b64_get_decoded_size(NULL, 4, &needs));
+    CU_ASSERT(0 == needs);
+    CU_ASSERT(2 == b64url_get_decoded_size((const uint8_t *) "TWE=", 4, NULL));
+    CU_ASSERT(0 == b64url_get_decoded_size((const uint8_t *) "TWFuT", 5, NULL));
+    CU_ASSERT(2 == b64url_get_decoded_size((const uint8_t *) "TWE", 3, NULL));
+    CU_ASSERT(0 == b64url_get_decoded_size((const uint8_t *) "TW+", 3, NULL));
+    CU_ASSERT(0 == b64_get_decoded_size_flags((const uint8_t *) "TWE=", 4,
+                                              B64_DECODE_PAD_FORBIDDEN, NULL));
+    CU_ASSERT(2 == b64_get_decoded_size_flags((const uint8_t *) "TWE=", 4,
+                                              B64_DECODE_PAD_OPTIONAL, NULL));
+    CU_ASSERT(2 == b64_get_decoded_size_flags((const uint8_t *) "TW-", 3,
+                                              B64_DECODE_ANY_ALPHABET | B64_DECODE_PAD_OPTIONAL, NULL));
+}
+
+void test_decode_constant_time(void)
+{
+    const unsigned modes[] = {
+        B64_DECODE_STANDARD | B64_DECODE_PAD_REQUIRED,
+        B64_DECODE_URL | B64_DECODE_PAD_OPTIONAL,
+        B64_DECODE_ANY_ALPHABET | B64_DECODE_PAD_OPTIONAL,
+        B64_DECODE_STANDARD | B64_DECODE_PAD_FORBIDDEN,
+    };
+    uint8_t raw[100];
+    uint8_t enc[140];
+    uint8_t fast[100];
+    uint8_t ct[100];
+
+    for (size_t i = 0; i < sizeof(raw); i++) {
+        raw[i] = (uint8_t) (i * 151 + 3);
+    }
+
+    /* Every mode agrees with the fast path on good input. */
+    for (size_t len = 1; len <= sizeof(raw); len++) {
+        for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+            unsigned flags = modes[m] | B64_DECODE_CONSTANT_TIME;
+            size_t n;
+
+            if (B64_DECODE_URL & modes[m]) {
+                b64url_encode(raw, len, enc);
+                n = b64url_get_encoded_buffer_size(len);
+            } else {
+                b64_encode(raw, len, enc);
+                n = b64_get_encoded_buffer_size(len);
+                if (B64_DECODE_PAD_FORBIDDEN & modes[m]) {
+                    while ('=' == enc[n - 1]) {
+                        n--;
+                    }
+                }
+            }
+
+            CU_ASSERT(len == b64_decode_flags(enc, n, fast, modes[m]));
+            CU_ASSERT(len == b64_decode_flags(enc, n, ct, flags));
+            CU_ASSERT(0 == memcmp(fast, ct, len));
+            CU_ASSERT(len == b64_get_decoded_size_flags(enc, n, flags, NULL));
+        }
+    }
+
+    /* Every byte value, at every position of a group, is judged the same way
+     * as the fast path, and a rejected decode leaves nothing behind. */
+    for (int c = 0; c < 256; c++) {
+        for (size_t pos = 0; pos < 8; pos++) {
+            size_t a, b;
+
+            memcpy(enc, "TWFuTWFu", 8);
+            enc[pos] = (uint8_t) c;
+            memset(ct, 0xaa, sizeof(ct));
+
+            a = b64_decode_flags(enc, 8, fast, B64_DECODE_ANY_ALPHABET);
+            b = b64_decode_flags(enc, 8, ct, B64_DECODE_ANY_ALPHABET | B64_DECODE_CONSTANT_TIME);
+            CU_ASSERT(a == b);
+            if (b) {
+                CU_ASSERT(0 == memcmp(fast, ct, b));
+            } else {
+                CU_ASSERT(0 == ct[0] && 0 == ct[5] && 0xaa == ct[6]);
+            }
+        }
+    }
+
+    CU_ASSERT(0 == b64_decode_flags((const uint8_t *) "TWE=", 3, ct,
+                                    B64_DECODE_PAD_REQUIRED | B64_DECODE_CONSTANT_TIME));
+    CU_ASSERT(0 == b64_decode_flags((const uint8_t *) "TWFuT", 5, ct, B64_DECODE_CONSTANT_TIME));
+    CU_ASSERT(0 == b64_decode_flags((const uint8_t *) "TWE=", 4, ct,
+                                    B64_DECODE_PAD_FORBIDDEN | B64_DECODE_CONSTANT_TIME));
+}
+
+void test_encoded_size_checked(void)
+{
+    const size_t too_long[] = { B64_MAX_ENCODE_LEN + 1, SIZE_MAX - 1, SIZE_MAX };
+    uint8_t raw[4]          = { 0 };
+    b64_buf_t buf           = { 0 };
+    size_t out_len;
+    int over;
+
+    for (size_t len = 0; len < 1000; len++) {
+        over = 99;
+        CU_ASSERT(b64_get_encoded_buffer_size(len)
+                  == b64_get_encoded_buffer_size_checked(len, &over));
+        CU_ASSERT(0 == over);
+        over = 99;
+        CU_ASSERT(b64url_get_encoded_buffer_size(len)
+                  == b64url_get_encoded_buffer_size_checked(len, &over));
+        CU_ASSERT(0 == over);
+    }
+
+    /* The longest input still leaves room for a '\0'. */
+    CU_ASSERT(SIZE_MAX - 3 == b64_get_encoded_buffer_size_checked(B64_MAX_ENCODE_LEN, &over));
+    CU_ASSERT(0 == over);
+    CU_ASSERT(SIZE_MAX - 3 == b64url_get_encoded_buffer_size_checked(B64_MAX_ENCODE_LEN, &over));
+    CU_ASSERT(0 == over);
+
+    /* The encoders that size their own output reject these before reading
+     * the (much shorter) input. */
+    for (size_t i = 0; i < sizeof(too_long) / sizeof(too_long[0]); i++) {
+        over = 0;
+        CU_ASSERT(0 == b64_get_encoded_buffer_size_checked(too_long[i], &over));
+        CU_ASSERT(1 == over);
+        over = 0;
+        CU_ASSERT(0 == b64url_get_encoded_buffer_size_checked(too_long[i], &over));
+        CU_ASSERT(1 == over);
+        CU_ASSERT(0 == b64_get_encoded_buffer_size_checked(too_long[i], NULL));
+
+        out_len = 99;
+        CU_ASSERT(NULL == b64_encode_with_alloc(raw, too_long[i], &out_len));
+        CU_ASSERT(0 == out_len);
+        out_len = 99;
+        CU_ASSERT(NULL == b64url_encode_with_alloc(raw, too_long[i], &out_len));
+        CU_ASSERT(0 == out_len);
+
+        CU_ASSERT(0 == b64_encode_append(&buf, raw, too_long[i]));
+        CU_ASSERT(0 == b64url_encode_append(&buf, raw, too_long[i]));
+        CU_ASSERT((NULL == buf.data) && (0 == buf.len));
+    }
+}
+
+/* Puts the chunks back together and counts them, stopping at stop_at. */
+struct chunks {
+    uint8_t data[3 * B64_DECODE_CHUNK_MAX];
+    size_t len;
+    size_t calls;
+    size_t sizes[4];
+    size_t stop_at;
+};
+
+static int collect_chunk(const uint8_t *raw, size_t len, void *user)
+{
+    struct chunks *c = user;
+
+    if (c->calls < 4) {
+        c->sizes[c->calls] = len;
+    }
+    c->calls++;
+    if ((c->stop_at == c->calls) || (sizeof(c->data) - c->len < len)) {
+        return -1;
+    }
+    memcpy(&c->data[c->len], raw, len);
+    c->len += len;
+
+    return 0;
+}
+
+void test_decode_chunked(void)
+{
+    static struct chunks c;
+    static uint8_t raw[2 * B64_DECODE_CHUNK_MAX + 100];
+    static uint8_t enc[sizeof(raw) / 3 * 4 + 8];
+    size_t n;
+
+    for (size_t i = 0; i < sizeof(raw); i++) {
+        raw[i] = (uint8_t) (i * 167 + 5);
+    }
+
+    /* Two full chunks and the rest, put back together exactly. */
+    b64_encode(raw, sizeof(raw), enc);
+    n = b64_get_encoded_buffer_size(sizeof(raw));
+    memset(&c, 0, sizeof(c));
+    CU_ASSERT(sizeof(raw)
+              == b64_decode_chunked(enc, n, B64_DECODE_PAD_REQUIRED, collect_chunk, &c));
+    CU_ASSERT(3 == c.calls);
+    CU_ASSERT(B64_DECODE_CHUNK_MAX == c.sizes[0] && B64_DECODE_CHUNK_MAX == c.sizes[1]);
+    CU_ASSERT(100 == c.sizes[2]);
+    CU_ASSERT(0 == memcmp(raw, c.data, sizeof(raw)));
+
+    /* Every length around a chunk boundary, padded or not. */
+    for (size_t len = B64_DECODE_CHUNK_MAX - 3; len <= B64_DECODE_CHUNK_MAX + 3; len++) {
+        b64url_encode(raw, len, enc);
+        n = b64url_get_encoded_buffer_size(len);
+        memset(&c, 0, sizeof(c));
+        CU_ASSERT(len == b64_decode_chunked(enc, n, B64_DECODE_URL, collect_chunk, &c));
+        CU_ASSERT((len + B64_DECODE_CHUNK_MAX - 1) / B64_DECODE_CHUNK_MAX == c.calls);
+        CU_ASSERT(0 == memcmp(raw, c.data, len));
+
+        b64_encode(raw, len, enc);
+        n = b64_get_encoded_buffer_size(len);
+        memset(&c, 0, sizeof(c));
+        CU_ASSERT(len == b64_decode_chunked(enc, n, B64_DECODE_CONSTANT_TIME, collect_chunk, &c));
+        CU_ASSERT(0 == memcmp(raw, c.data, len));
+    }
+
+    /* A bad character in the second chunk is found after the first chunk has
+     * been passed on. */
+    b64_encode(raw, sizeof(raw), enc);
+    n         = b64_get_encoded_buffer_size(sizeof(raw));
+    enc[9000] = '.';
+    memset(&c, 0, sizeof(c));
+    CU_ASSERT(0 == b64_decode_chunked(enc, n, B64_DECODE_STANDARD, collect_chunk, &c));
+    CU_ASSERT(1 == c.calls);
+
+    /* In constant time mode the decode goes on to the end, but nothing after
+     * the bad chunk reaches the callback, wherever it is. */
+    memset(&c, 0, sizeof(c));
+    CU_ASSERT(0 == b64_decode_chunked(enc, n, B64_DECODE_CONSTANT_TIME, collect_chunk, &c));
+    CU_ASSERT(1 == c.calls);
+    enc[9000] = enc[9001];
+    enc[10]   = '.';
+    memset(&c, 0, sizeof(c));
+    CU_ASSERT(0 == b64_decode_chunked(enc, n, B64_DECODE_CONSTANT_TIME, collect_chunk, &c));
+    CU_ASSERT(0 == c.calls);
+
+    /* Padding that ends a chunk but not the input. */
+    b64_encode(raw, B64_DECODE_CHUNK_MAX - 1, enc);
+    memcpy(&enc[(B64_DECODE_CHUNK_MAX / 3) * 4], "TWFu", 4);
+    n = (B64_DECODE_CHUNK_MAX / 3) * 4 + 4;
+    memset(&c, 0, sizeof(c));
+    CU_ASSERT(0 == b64_decode_flags(enc, n, c.data, B64_DECODE_STANDARD));
+    CU_ASSERT(0 == b64_decode_chunked(enc, n, B64_DECODE_STANDARD, collect_chunk, &c));
+
+    /* A length no input could have is rejected before any chunk. */
+    memset(&c, 0, sizeof(c));
+    CU_ASSERT(0 == b64_decode_chunked(enc, 8193, B64_DECODE_PAD_REQUIRED, collect_chunk, &c));
+    CU_ASSERT(0 == b64_decode_chunked(enc, 0, B64_DECODE_STANDARD, collect_chunk, &c));
+    CU_ASSERT(0 == c.calls);
+
+    /* The callback can stop the decode. */
+    b64_encode(raw, sizeof(raw), enc);
+    n = b64_get_encoded_buffer_size(sizeof(raw));
+    memset(&c, 0, sizeof(c));
+    c.stop_at = 2;
+    CU_ASSERT(0 == b64_decode_chunked(enc, n, B64_DECODE_STANDARD, collect_chunk, &c));
+    CU_ASSERT(2 == c.calls);
+
+    CU_ASSERT(0 == b64_decode_chunked(NULL, 4, B64_DECODE_STANDARD, collect_chunk, &c));
+    CU_ASSERT(0 == b64_decode_chunked(enc, 4, B64_DECODE_STANDARD, NULL, &c));
+}
+
 void add_suites(CU_pSuite *suite)
 {
     *suite = CU_add_suite("Base64 encoding tests", NULL, NULL);
@@ -564,6 +1289,16 @@ void add_suites(CU_pSuite *suite)
     CU_add_test(*suite, "Test URL Encoding         ", test_url_encode);
     CU_add_test(*suite, "Test Alloc Decoding       ", test_decode_w_alloc);
     CU_add_test(*suite, "Test Alloc Encoding       ", test_encode_w_alloc);
+    CU_add_test(*suite, "Test Append               ", test_append);
+    CU_add_test(*suite, "Test JSON Decoding        ", test_decode_json);
+    CU_add_test(*suite, "Test Flags Decoding       ", test_decode_flags);
+    CU_add_test(*suite, "Test UTF-16               ", test_utf16);
+    CU_add_test(*suite, "Test Long Inputs          ", test_long_inputs);
+    CU_add_test(*suite, "Test In Place Decoding    ", test_decode_in_place);
+    CU_add_test(*suite, "Test the Exact Size       ", test_decoded_size_exact);
+    CU_add_test(*suite, "Test Constant Time Decode ", test_decode_constant_time);
+    CU_add_test(*suite, "Test Checked Encoded Size ", test_encoded_size_checked);
+    CU_add_test(*suite, "Test Chunked Decoding     ", test_decode_chunked);
 }
 
 /*----------------------------------------------------------------------------*/
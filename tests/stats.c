@@ -0,0 +1,275 @@
+/* SPDX-FileCopyrightText: 2026 Comcast Cable Communications Management, LLC */
+/* SPDX-License-Identifier: Apache-2.0 */
+#include <CUnit/Basic.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/trower-base64/base64.h"
+#include "../include/trower-base64/datauri.h"
+#include "../include/trower-base64/pem.h"
+#include "../include/trower-base64/stats.h"
+
+static int enabled(void)
+{
+    b64_stats_t s;
+
+    b64_stats_snapshot(&s);
+    return s.enabled;
+}
+
+void test_names(void)
+{
+    for (int i = 0; i < B64_STATS_FN_COUNT; i++) {
+        const char *name = b64_stats_fn_name((enum b64_stats_fn) i);
+        CU_ASSERT_FATAL(NULL != name);
+        CU_ASSERT(0 == strncmp(name, "b64", 3));
+    }
+    CU_ASSERT(NULL == b64_stats_fn_name(B64_STATS_FN_COUNT));
+
+    for (int i = 0; i < B64_STATS_KERNEL_COUNT; i++) {
+        CU_ASSERT(NULL != b64_stats_kernel_name((enum b64_stats_kernel) i));
+    }
+    CU_ASSERT(NULL == b64_stats_kernel_name(B64_STATS_KERNEL_COUNT));
+    CU_ASSERT(B64_STATS_KERNEL_COUNT <= B64_STATS_KERNEL_MAX);
+}
+
+void test_counts(void)
+{
+    b64_stats_t *s = calloc(1, sizeof(b64_stats_t));
+    uint8_t out[16];
+    char *p;
+    size_t len;
+
+    CU_ASSERT_FATAL(NULL != s);
+
+    b64_stats_reset();
+    b64_encode((const uint8_t *) "Man", 3, out);
+    b64_encode((const uint8_t *) "", 0, out);
+    CU_ASSERT(3 == b64_decode((const uint8_t *) "TWFu", 4, out));
+    CU_ASSERT(0 == b64_decode((const uint8_t *) "TW|u", 4, out));
+    p = b64_encode_with_alloc((const uint8_t *) "Man is", 6, &len);
+    free(p);
+
+    b64_stats_snapshot(s);
+
+    if (!s->enabled) {
+        /* Nothing is counted when the option is off. */
+        const uint8_t *raw = (const uint8_t *) s->fn;
+        for (size_t i = 0; i < sizeof(s->fn); i++) {
+            CU_ASSERT_FATAL(0 == raw[i]);
+        }
+        free(s);
+        return;
+    }
+
+    CU_ASSERT(2 == s->fn[B64_STATS_ENCODE].calls);
+    CU_ASSERT(3 == s->fn[B64_STATS_ENCODE].bytes);
+    CU_ASSERT(0 == s->fn[B64_STATS_ENCODE].errors);
+    CU_ASSERT(1 == s->fn[B64_STATS_ENCODE].size_log2[0]);
+    CU_ASSERT(1 == s->fn[B64_STATS_ENCODE].size_log2[2]);
+    CU_ASSERT(2 == s->fn[B64_STATS_DECODE].calls);
+    CU_ASSERT(1 == s->fn[B64_STATS_DECODE].errors);
+    CU_ASSERT(2 == s->fn[B64_STATS_DECODE].size_log2[3]);
+    CU_ASSERT(1 == s->fn[B64_STATS_ENCODE_WITH_ALLOC].calls);
+    CU_ASSERT(1 == s->fn[B64_STATS_ENCODE_WITH_ALLOC].size_log2[3]);
+
+    /* Nested internal calls are not double counted. */
+    CU_ASSERT(2 == s->fn[B64_STATS_ENCODE].calls);
+
+    uint64_t kernels = 0;
+    for (int i = 0; i < B64_STATS_KERNEL_MAX; i++) {
+        kernels += s->fn[B64_STATS_DECODE].kernel[i];
+    }
+    CU_ASSERT(2 == kernels);
+
+    b64_stats_reset();
+    b64_stats_snapshot(s);
+    CU_ASSERT(0 == s->fn[B64_STATS_ENCODE].calls);
+    CU_ASSERT(0 == s->fn[B64_STATS_DECODE].errors);
+
+    free(s);
+}
+
+void test_kernels(void)
+{
+    b64_stats_t *s = calloc(1, sizeof(b64_stats_t));
+    uint8_t out[16];
+
+    CU_ASSERT_FATAL(NULL != s);
+    if (!enabled()) {
+        free(s);
+        return;
+    }
+
+    /* A constant time decode is counted under the loop that actually ran,
+     * not the build's kernel. */
+    b64_stats_reset();
+    CU_ASSERT(3 == b64_decode_flags((const uint8_t *) "TWFu", 4, out, B64_DECODE_CONSTANT_TIME));
+    CU_ASSERT(3 == b64_decode_flags((const uint8_t *) "TWFu", 4, out, 0));
+    b64_stats_snapshot(s);
+    CU_ASSERT(2 == s->fn[B64_STATS_DECODE_FLAGS].calls);
+    CU_ASSERT(1 == s->fn[B64_STATS_DECODE_FLAGS].kernel[B64_STATS_KERNEL_CONSTANT_TIME]);
+
+    free(s);
+}
+
+void test_internal_calls(void)
+{
+    const char pem[] = "-----BEGIN X-----\nTWFu\n-----END X-----\n";
+    b64_stats_t *s   = calloc(1, sizeof(b64_stats_t));
+    b64_data_uri_t uri;
+    b64_pem_t blocks;
+    char enc[64];
+    uint8_t out[16];
+    size_t len;
+
+    CU_ASSERT_FATAL(NULL != s);
+    if (!enabled()) {
+        free(s);
+        return;
+    }
+
+    /* The other APIs are built on the codec but are not codec calls. */
+    b64_stats_reset();
+    len = b64_data_uri_encode("text/plain", 10, (const uint8_t *) "Man", 3, enc);
+    CU_ASSERT(3 == b64_data_uri_parse(enc, len, &uri));
+    CU_ASSERT(3 == b64_data_uri_decode(&uri, out));
+    CU_ASSERT(1 == b64_pem_decode((const uint8_t *) pem, sizeof(pem) - 1, &blocks));
+    b64_pem_free(&blocks);
+
+    b64_stats_snapshot(s);
+    for (int i = 0; i < B64_STATS_FN_COUNT; i++) {
+        CU_ASSERT(0 == s->fn[i].calls);
+    }
+
+    free(s);
+}
+
+static void *worker(void *arg)
+{
+    uint8_t out[8];
+
+    (void) arg;
+    for (int i = 0; i < 1000; i++) {
+        b64url_encode((const uint8_t *) "Man", 3, out);
+    }
+    return NULL;
+}
+
+void test_threads(void)
+{
+    b64_stats_t *s = calloc(1, sizeof(b64_stats_t));
+    pthread_t t[4];
+
+    CU_ASSERT_FATAL(NULL != s);
+    if (!enabled()) {
+        free(s);
+        return;
+    }
+
+    b64_stats_reset();
+    for (int i = 0; i < 4; i++) {
+        CU_ASSERT_FATAL(0 == pthread_create(&t[i], NULL, worker, NULL));
+    }
+    for (int i = 0; i < 4; i++) {
+        pthread_join(t[i], NULL);
+    }
+
+    /* The counts of exited threads remain. */
+    b64_stats_snapshot(s);
+    CU_ASSERT(4000 == s->fn[B64_STATS_URL_ENCODE].calls);
+    CU_ASSERT(12000 == s->fn[B64_STATS_URL_ENCODE].bytes);
+    free(s);
+}
+
+static void *short_worker(void *arg)
+{
+    uint8_t out[4];
+
+    (void) arg;
+    for (int i = 0; i < 10; i++) {
+        b64_decode((const uint8_t *) "TWFu", 4, out);
+    }
+    return NULL;
+}
+
+void test_thread_churn(void)
+{
+    b64_stats_t *s = calloc(1, sizeof(b64_stats_t));
+    pthread_t t[4];
+
+    CU_ASSERT_FATAL(NULL != s);
+    if (!enabled()) {
+        free(s);
+        return;
+    }
+
+    /* Thread per connection servers start and end threads all the time; the
+     * blocks of the exited ones are reused and their counts kept. */
+    b64_stats_reset();
+    for (int round = 0; round < 100; round++) {
+        for (int i = 0; i < 4; i++) {
+            CU_ASSERT_FATAL(0 == pthread_create(&t[i], NULL, short_worker, NULL));
+        }
+        for (int i = 0; i < 4; i++) {
+            pthread_join(t[i], NULL);
+        }
+        if (0 == round % 10) {
+            b64_stats_snapshot(s);
+            CU_ASSERT((uint64_t) (round + 1) * 40 == s->fn[B64_STATS_DECODE].calls);
+        }
+    }
+
+    b64_stats_snapshot(s);
+    CU_ASSERT(4000 == s->fn[B64_STATS_DECODE].calls);
+    CU_ASSERT(16000 == s->fn[B64_STATS_DECODE].bytes);
+    CU_ASSERT(0 == s->fn[B64_STATS_DECODE].errors);
+
+    /* A reset still starts from zero with retired counts around. */
+    b64_stats_reset();
+    b64_stats_snapshot(s);
+    CU_ASSERT(0 == s->fn[B64_STATS_DECODE].calls);
+    free(s);
+}
+
+void add_suites(CU_pSuite *suite)
+{
+    *suite = CU_add_suite("Base64 statistics tests", NULL, NULL);
+    CU_add_test(*suite, "Test names                ", test_names);
+    CU_add_test(*suite, "Test counts               ", test_counts);
+    CU_add_test(*suite, "Test kernels              ", test_kernels);
+    CU_add_test(*suite, "Test internal calls       ", test_internal_calls);
+    CU_add_test(*suite, "Test threads              ", test_threads);
+    CU_add_test(*suite, "Test thread churn         ", test_thread_churn);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                             External Functions                             */
+/*----------------------------------------------------------------------------*/
+int main(void)
+{
+    unsigned rv     = 1;
+    CU_pSuite suite = NULL;
+
+    if (CUE_SUCCESS == CU_initialize_registry()) {
+        add_suites(&suite);
+
+        if (NULL != suite) {
+            CU_basic_set_mode(CU_BRM_VERBOSE);
+            CU_basic_run_tests();
+            printf("\n");
+            CU_basic_show_failures(CU_get_failure_list());
+            printf("\n\n");
+            rv = CU_get_number_of_tests_failed();
+        }
+
+        CU_cleanup_registry();
+    }
+
+    if (0 != rv) {
+        return 1;
+    }
+    return 0;
+}